@@ -87,18 +87,7 @@ const osThreadAttr_t lvHandler_attributes = {
   .cb_size = sizeof(lvHandlerControlBlock),
   .stack_mem = &lvHandlerBuffer[0],
   .stack_size = sizeof(lvHandlerBuffer),
-  .priority = (osPriority_t) osPriorityRealtime,
-};
-/* Definitions for InputFlagQueue */
-osMessageQueueId_t InputFlagQueueHandle;
-uint8_t InputFlagQueueBuffer[ 1 * sizeof( uint32_t ) ];
-osStaticMessageQDef_t InputFlagQueueControlBlock;
-const osMessageQueueAttr_t InputFlagQueue_attributes = {
-  .name = "InputFlagQueue",
-  .cb_mem = &InputFlagQueueControlBlock,
-  .cb_size = sizeof(InputFlagQueueControlBlock),
-  .mq_mem = &InputFlagQueueBuffer,
-  .mq_size = sizeof(InputFlagQueueBuffer)
+  .priority = (osPriority_t) osPriorityBelowNormal,
 };
 /* Definitions for LvMutex */
 osMutexId_t LvMutexHandle;
@@ -158,10 +147,6 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE END RTOS_TIMERS */
 
-  /* Create the queue(s) */
-  /* creation of InputFlagQueue */
-  InputFlagQueueHandle = osMessageQueueNew (1, sizeof(uint32_t), &InputFlagQueue_attributes);
-
   /* USER CODE BEGIN RTOS_QUEUES */
   /* add queues, ... */
   /* USER CODE END RTOS_QUEUES */
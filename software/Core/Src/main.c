@@ -117,6 +117,7 @@ int main(void)
   MX_DAC1_Init();
   MX_SPI1_Init();
   MX_TIM2_Init();
+  MX_TIM3_Init();
   /* USER CODE BEGIN 2 */
 
 	dp_init();
@@ -6,15 +6,66 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../Program/SignalsProcessing/Src/app_signal.c \
-../Program/SignalsProcessing/Src/metal_detecting.c 
+../Program/SignalsProcessing/Src/metal_detecting.c \
+../Program/SignalsProcessing/Src/iq_demod.c \
+../Program/SignalsProcessing/Src/fft_plan.c \
+../Program/SignalsProcessing/Src/load_kernel.c \
+../Program/SignalsProcessing/Src/sliding_dft.c \
+../Program/SignalsProcessing/Src/freq_plan.c \
+../Program/SignalsProcessing/Src/window_table.c \
+../Program/SignalsProcessing/Src/frame_ring.c \
+../Program/SignalsProcessing/Src/capture.c \
+../Program/SignalsProcessing/Src/deadline_monitor.c \
+../Program/SignalsProcessing/Src/decimator.c \
+../Program/SignalsProcessing/Src/iq_stream.c \
+../Program/SignalsProcessing/Src/sync_average.c \
+../Program/SignalsProcessing/Src/ground_balance.c \
+../Program/SignalsProcessing/Src/discrimination.c \
+../Program/SignalsProcessing/Src/target_event.c \
+../Program/SignalsProcessing/Src/target_tracker.c \
+../Program/SignalsProcessing/Src/packed_fft.c 
 
 OBJS += \
 ./Program/SignalsProcessing/Src/app_signal.o \
-./Program/SignalsProcessing/Src/metal_detecting.o 
+./Program/SignalsProcessing/Src/metal_detecting.o \
+./Program/SignalsProcessing/Src/iq_demod.o \
+./Program/SignalsProcessing/Src/fft_plan.o \
+./Program/SignalsProcessing/Src/load_kernel.o \
+./Program/SignalsProcessing/Src/sliding_dft.o \
+./Program/SignalsProcessing/Src/freq_plan.o \
+./Program/SignalsProcessing/Src/window_table.o \
+./Program/SignalsProcessing/Src/frame_ring.o \
+./Program/SignalsProcessing/Src/capture.o \
+./Program/SignalsProcessing/Src/deadline_monitor.o \
+./Program/SignalsProcessing/Src/decimator.o \
+./Program/SignalsProcessing/Src/iq_stream.o \
+./Program/SignalsProcessing/Src/sync_average.o \
+./Program/SignalsProcessing/Src/ground_balance.o \
+./Program/SignalsProcessing/Src/discrimination.o \
+./Program/SignalsProcessing/Src/target_event.o \
+./Program/SignalsProcessing/Src/target_tracker.o \
+./Program/SignalsProcessing/Src/packed_fft.o 
 
 C_DEPS += \
 ./Program/SignalsProcessing/Src/app_signal.d \
-./Program/SignalsProcessing/Src/metal_detecting.d 
+./Program/SignalsProcessing/Src/metal_detecting.d \
+./Program/SignalsProcessing/Src/iq_demod.d \
+./Program/SignalsProcessing/Src/fft_plan.d \
+./Program/SignalsProcessing/Src/load_kernel.d \
+./Program/SignalsProcessing/Src/sliding_dft.d \
+./Program/SignalsProcessing/Src/freq_plan.d \
+./Program/SignalsProcessing/Src/window_table.d \
+./Program/SignalsProcessing/Src/frame_ring.d \
+./Program/SignalsProcessing/Src/capture.d \
+./Program/SignalsProcessing/Src/deadline_monitor.d \
+./Program/SignalsProcessing/Src/decimator.d \
+./Program/SignalsProcessing/Src/iq_stream.d \
+./Program/SignalsProcessing/Src/sync_average.d \
+./Program/SignalsProcessing/Src/ground_balance.d \
+./Program/SignalsProcessing/Src/discrimination.d \
+./Program/SignalsProcessing/Src/target_event.d \
+./Program/SignalsProcessing/Src/target_tracker.d \
+./Program/SignalsProcessing/Src/packed_fft.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -24,7 +75,7 @@ Program/SignalsProcessing/Src/%.o Program/SignalsProcessing/Src/%.su Program/Sig
 clean: clean-Program-2f-SignalsProcessing-2f-Src
 
 clean-Program-2f-SignalsProcessing-2f-Src:
-	-$(RM) ./Program/SignalsProcessing/Src/app_signal.cyclo ./Program/SignalsProcessing/Src/app_signal.d ./Program/SignalsProcessing/Src/app_signal.o ./Program/SignalsProcessing/Src/app_signal.su ./Program/SignalsProcessing/Src/metal_detecting.cyclo ./Program/SignalsProcessing/Src/metal_detecting.d ./Program/SignalsProcessing/Src/metal_detecting.o ./Program/SignalsProcessing/Src/metal_detecting.su
+	-$(RM) ./Program/SignalsProcessing/Src/app_signal.cyclo ./Program/SignalsProcessing/Src/app_signal.d ./Program/SignalsProcessing/Src/app_signal.o ./Program/SignalsProcessing/Src/app_signal.su ./Program/SignalsProcessing/Src/metal_detecting.cyclo ./Program/SignalsProcessing/Src/metal_detecting.d ./Program/SignalsProcessing/Src/metal_detecting.o ./Program/SignalsProcessing/Src/metal_detecting.su ./Program/SignalsProcessing/Src/iq_demod.cyclo ./Program/SignalsProcessing/Src/iq_demod.d ./Program/SignalsProcessing/Src/iq_demod.o ./Program/SignalsProcessing/Src/iq_demod.su ./Program/SignalsProcessing/Src/fft_plan.cyclo ./Program/SignalsProcessing/Src/fft_plan.d ./Program/SignalsProcessing/Src/fft_plan.o ./Program/SignalsProcessing/Src/fft_plan.su ./Program/SignalsProcessing/Src/load_kernel.cyclo ./Program/SignalsProcessing/Src/load_kernel.d ./Program/SignalsProcessing/Src/load_kernel.o ./Program/SignalsProcessing/Src/load_kernel.su ./Program/SignalsProcessing/Src/sliding_dft.cyclo ./Program/SignalsProcessing/Src/sliding_dft.d ./Program/SignalsProcessing/Src/sliding_dft.o ./Program/SignalsProcessing/Src/sliding_dft.su ./Program/SignalsProcessing/Src/freq_plan.cyclo ./Program/SignalsProcessing/Src/freq_plan.d ./Program/SignalsProcessing/Src/freq_plan.o ./Program/SignalsProcessing/Src/freq_plan.su ./Program/SignalsProcessing/Src/window_table.cyclo ./Program/SignalsProcessing/Src/window_table.d ./Program/SignalsProcessing/Src/window_table.o ./Program/SignalsProcessing/Src/window_table.su ./Program/SignalsProcessing/Src/frame_ring.cyclo ./Program/SignalsProcessing/Src/frame_ring.d ./Program/SignalsProcessing/Src/frame_ring.o ./Program/SignalsProcessing/Src/frame_ring.su ./Program/SignalsProcessing/Src/capture.cyclo ./Program/SignalsProcessing/Src/capture.d ./Program/SignalsProcessing/Src/capture.o ./Program/SignalsProcessing/Src/capture.su ./Program/SignalsProcessing/Src/deadline_monitor.cyclo ./Program/SignalsProcessing/Src/deadline_monitor.d ./Program/SignalsProcessing/Src/deadline_monitor.o ./Program/SignalsProcessing/Src/deadline_monitor.su ./Program/SignalsProcessing/Src/decimator.cyclo ./Program/SignalsProcessing/Src/decimator.d ./Program/SignalsProcessing/Src/decimator.o ./Program/SignalsProcessing/Src/decimator.su ./Program/SignalsProcessing/Src/iq_stream.cyclo ./Program/SignalsProcessing/Src/iq_stream.d ./Program/SignalsProcessing/Src/iq_stream.o ./Program/SignalsProcessing/Src/iq_stream.su ./Program/SignalsProcessing/Src/sync_average.cyclo ./Program/SignalsProcessing/Src/sync_average.d ./Program/SignalsProcessing/Src/sync_average.o ./Program/SignalsProcessing/Src/sync_average.su ./Program/SignalsProcessing/Src/ground_balance.cyclo ./Program/SignalsProcessing/Src/ground_balance.d ./Program/SignalsProcessing/Src/ground_balance.o ./Program/SignalsProcessing/Src/ground_balance.su ./Program/SignalsProcessing/Src/discrimination.cyclo ./Program/SignalsProcessing/Src/discrimination.d ./Program/SignalsProcessing/Src/discrimination.o ./Program/SignalsProcessing/Src/discrimination.su ./Program/SignalsProcessing/Src/target_event.cyclo ./Program/SignalsProcessing/Src/target_event.d ./Program/SignalsProcessing/Src/target_event.o ./Program/SignalsProcessing/Src/target_event.su ./Program/SignalsProcessing/Src/target_tracker.cyclo ./Program/SignalsProcessing/Src/target_tracker.d ./Program/SignalsProcessing/Src/target_tracker.o ./Program/SignalsProcessing/Src/target_tracker.su ./Program/SignalsProcessing/Src/packed_fft.cyclo ./Program/SignalsProcessing/Src/packed_fft.d ./Program/SignalsProcessing/Src/packed_fft.o ./Program/SignalsProcessing/Src/packed_fft.su
 
 .PHONY: clean-Program-2f-SignalsProcessing-2f-Src
 
@@ -5,13 +5,16 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../Program/Tasks/Src/app_tasks.c 
+../Program/Tasks/Src/app_tasks.c \
+../Program/Tasks/Src/meas_bus.c 
 
 OBJS += \
-./Program/Tasks/Src/app_tasks.o 
+./Program/Tasks/Src/app_tasks.o \
+./Program/Tasks/Src/meas_bus.o 
 
 C_DEPS += \
-./Program/Tasks/Src/app_tasks.d 
+./Program/Tasks/Src/app_tasks.d \
+./Program/Tasks/Src/meas_bus.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -21,7 +24,7 @@ Program/Tasks/Src/%.o Program/Tasks/Src/%.su Program/Tasks/Src/%.cyclo: ../Progr
 clean: clean-Program-2f-Tasks-2f-Src
 
 clean-Program-2f-Tasks-2f-Src:
-	-$(RM) ./Program/Tasks/Src/app_tasks.cyclo ./Program/Tasks/Src/app_tasks.d ./Program/Tasks/Src/app_tasks.o ./Program/Tasks/Src/app_tasks.su
+	-$(RM) ./Program/Tasks/Src/app_tasks.cyclo ./Program/Tasks/Src/app_tasks.d ./Program/Tasks/Src/app_tasks.o ./Program/Tasks/Src/app_tasks.su ./Program/Tasks/Src/meas_bus.cyclo ./Program/Tasks/Src/meas_bus.d ./Program/Tasks/Src/meas_bus.o ./Program/Tasks/Src/meas_bus.su
 
 .PHONY: clean-Program-2f-Tasks-2f-Src
 
@@ -16,18 +16,23 @@
 
 #include <stdint.h>
 #include "arm_math.h"
+#include "signal_config.h"
+#include "freq_plan.h"
+#include "fft_plan.h"
+#include "window_table.h"
+#include "frame_ring.h"
 
-/** @brief Length of the output sine wave signal array. */
-#define OUTPUT_SINE_SIGNAL_LEN              10
+/** @brief Length of the output sine wave signal array (one TX period, see freq_plan.h). */
+#define OUTPUT_SINE_SIGNAL_LEN             FP_DAC_TX_TABLE_LEN
 
-/** @brief Length of the output audio signal array. */
-#define OUTPUT_SINE_AUDIO_LEN              100
+/** @brief Length of the output audio signal array (one audio period, see freq_plan.h). */
+#define OUTPUT_SINE_AUDIO_LEN              FP_AUDIO_TABLE_LEN
 
-/** @brief Length of the input buffer for ADC samples. */
-#define INPUT_BUFF_LEN                     2048
+/** @brief Length of the input buffer for ADC samples (the whole capture ring). */
+#define INPUT_BUFF_LEN                     ( SIG_CAPTURE_BLOCK_COUNT * FP_BLOCK_LEN )
 
-/** @brief Number of samples to be used for the FFT (half of the input buffer length). */
-#define BUFF_TO_DFT_LEN                    ( INPUT_BUFF_LEN / 2 )
+/** @brief Number of samples to be used for the FFT (one block of the capture ring). */
+#define BUFF_TO_DFT_LEN                    FP_BLOCK_LEN
 
 /** @brief Number of frequency domain bins (quarter of the input buffer length). */
 #define FREQ_DOMAIN_LEN                    ( BUFF_TO_DFT_LEN / 2 )
@@ -35,17 +40,81 @@
 /** @brief Length of the polar form array (same as frequency domain length). */
 #define POLAR_FORM_LEN                     FREQ_DOMAIN_LEN
 
-/** @brief Maximum value of the ADC output (12-bit resolution). */
-#define ADC_MAX_VALUE                      4095
+#if SIG_FRONTEND == SIG_FRONTEND_DIRECT
+/** @brief Number of bits of the sample codes in the input buffer. */
+#define SIG_ADC_BITS                       12
+#else
+/** @brief Number of bits of the sample codes in the input buffer, 12-bit conversions averaged to 14 bits. */
+#define SIG_ADC_BITS                       14
+#endif
+
+/** @brief Number of bits the sample codes carry beyond a 12-bit conversion, removed from every magnitude. */
+#define SIG_CODE_SHIFT                     ( SIG_ADC_BITS - 12 )
+
+/** @brief Maximum value of the sample codes. */
+#define ADC_MAX_VALUE                      ( ( 1 << SIG_ADC_BITS ) - 1 )
 
 /** @brief Reference voltage for the ADC. */
 #define REF_VOLTAGE                        3.3f
 
-/** @brief Flag indicating that the ADC conversion is complete for the first half of the buffer. */
-#define ADC_HALF_COMPLETE_FLAG             0
+/** @brief Number of raw samples kept by sig_view_snapshot() for the time domain chart. */
+#define SIG_SNAPSHOT_LEN                   128
+
+/** @brief Number of analysed samples produced per raw block of the decimating front-end. */
+#define SIG_DEC_CHUNK_LEN                  128
+
+/** @brief Number of raw samples per block of the decimating front-end, decimated in one ADC interrupt. */
+#define SIG_DEC_RAW_BLOCK_LEN              ( SIG_DEC_CHUNK_LEN * SIG_DECIMATION )
+
+/** @brief Number of bins converted per arm_cmplx_mag_f32() call by sig_update_polar(). */
+#define SIG_POLAR_CHUNK_LEN                32
+
+/** @brief Offset of the ADC codes around which the coil signals swing. */
+#define ADC_MID_SCALE                      ( ( ADC_MAX_VALUE + 1 ) / 2 )
+
+/** @brief Left shift that converts an offset-free sample code to full scale Q15. */
+#define SIG_Q15_INPUT_SHIFT                ( 16 - SIG_ADC_BITS )
+
+/** @brief Right shift that converts a Q15 (2.14) bin magnitude to the scale of the float path. */
+#define SIG_Q15_MAGNITUDE_SHIFT            4
+
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+/** @brief Converts a polar form phase (angle / pi in Q15) to radians. */
+#define SIG_PHASE_TO_RADIANS(phase)        ( (float32_t)(phase) * ( PI / 32768.0f ) )
+#else
+/** @brief Converts a polar form phase (already in radians) to radians. */
+#define SIG_PHASE_TO_RADIANS(phase)        ( phase )
+#endif
+
+
+/**
+ * @brief Status returned by the signal processing functions.
+ */
+typedef enum
+{
+    SIG_OK = 0,                     /*!< Operation completed successfully */
+    SIG_ERROR                       /*!< Invalid parameter or operation failed */
+} SIG_Status_t;
+
 
-/** @brief Flag indicating that the ADC conversion is complete for the entire buffer. */
-#define ADC_FULL_COMPLETE_FLAG             1
+/**
+ * @brief Transform used by sig_perform_fft() to get the spectra of both coils.
+ */
+typedef enum
+{
+    SIG_TRANSFORM_REAL = 0,         /*!< Two real FFTs, one per coil */
+    SIG_TRANSFORM_PACKED            /*!< One complex FFT with TX in the real and RX in the imaginary part */
+} SIG_TransformMode_t;
+
+
+/**
+ * @brief Signal driven to the TX coil by DAC channel 2.
+ */
+typedef enum
+{
+    SIG_TX_SINGLE = 0,              /*!< Single sine at the TX frequency of the frequency plan */
+    SIG_TX_MULTI                    /*!< Sum of FP_MT_TONE_COUNT tones, see fp_generate_multitone() */
+} SIG_TxMode_t;
 
 
 /**
@@ -78,26 +147,137 @@ typedef struct
 } SIG_PolarForm_t;
 
 
+/**
+ * @brief Structure representing a Q15 complex number in the frequency domain.
+ */
+typedef struct
+{
+    q15_t real_part;       			/*!< Real part of the complex number */
+    q15_t imaginary_part;  			/*!< Imaginary part of the complex number */
+} SIG_FreqDomainQ15_t;
+
+
+/**
+ * @brief Structure representing the Q15 magnitude and phase of a frequency component.
+ */
+typedef struct
+{
+    q15_t phase;       				/*!< Phase as angle / pi in Q15 */
+    q15_t magnitude;   				/*!< Magnitude in the scale of the float path (ADC codes) */
+} SIG_PolarFormQ15_t;
+
+
+/**
+ * @brief Read-only view of one completed block of the ADC capture ring.
+ *
+ * A view is handed out by sig_view_acquire() and returned with
+ * sig_view_release(). While it is held, the DMA writes into the other blocks.
+ */
+typedef struct
+{
+    const SIG_ADCRegister_t *samples;   /*!< First sample of the block */
+    uint16_t len;                       /*!< Number of samples in the block */
+    uint8_t block;                      /*!< Index of the block in the capture ring */
+    uint32_t sequence;                  /*!< Sequence number of the frame descriptor */
+} SIG_View_t;
+
+
+/**
+ * @brief RX magnitude and cross spectrum of the TX frequency bin.
+ */
+typedef struct
+{
+    float32_t rx_magnitude;             /*!< Magnitude of the RX bin */
+    float32_t tx_magnitude;             /*!< Magnitude of the TX bin */
+    float32_t real_part;                /*!< Real part of RX * conj(TX), in squared magnitude units */
+    float32_t imaginary_part;           /*!< Imaginary part of RX * conj(TX), in squared magnitude units */
+} SIG_CrossSpectrum_t;
+
+
+/**
+ * @brief Cycle counts of the polar conversion of one bin and of all bins.
+ */
+typedef struct
+{
+    uint32_t bin_cycles;            /*!< Cycles of sig_update_polar() for the TX bin only */
+    uint32_t all_cycles;            /*!< Cycles of sig_update_polar() for all bins */
+} SIG_PolarBenchmark_t;
+
+
 /**
  * @brief Handle structure for managing signal processing tasks.
+ *
+ * With SIG_ARITHMETIC_Q15 the sample buffers and polar forms are Q15, and both
+ * coils share one spectrum buffer, which halves the processing buffer memory.
+ * Only the RX spectrum is kept, so there is no TX polar form in that build.
  */
 typedef struct SIG_Handle_t
 {
     SIG_ADCRegister_t input_sig[INPUT_BUFF_LEN];  				/*!< Buffer for ADC input samples */
 
-    float32_t rx_coil_sig_to_dft[BUFF_TO_DFT_LEN]; 				/*!< Buffer for RX coil signal before FFT */
-    float32_t tx_coil_sig_to_dft[BUFF_TO_DFT_LEN]; 				/*!< Buffer for TX coil signal before FFT */
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+    q15_t rx_coil_sig_to_dft[BUFF_TO_DFT_LEN]; 					/*!< Buffer for RX coil signal before FFT */
+    q15_t tx_coil_sig_to_dft[BUFF_TO_DFT_LEN]; 					/*!< Buffer for TX coil signal before FFT */
+
+    SIG_FreqDomainQ15_t freq_domain[BUFF_TO_DFT_LEN];			/*!< Full spectrum of one coil, reused for RX and TX */
+
+    SIG_PolarFormQ15_t rx_coil_polar[POLAR_FORM_LEN]; 			/*!< Polar form of RX coil frequency domain data */
+    SIG_FreqDomainQ15_t rx_tx_bin;								/*!< RX spectrum at the TX frequency, kept for sig_cross_spectrum() */
+    SIG_FreqDomainQ15_t tx_tx_bin;								/*!< TX spectrum at the TX frequency, kept for sig_cross_spectrum() */
+
+    const arm_rfft_instance_q15 *fft_plan;						/*!< Cached Q15 FFT instance shared by both coils */
+#else
+    union
+    {
+        struct
+        {
+            float32_t rx_coil_sig_to_dft[BUFF_TO_DFT_LEN]; 		/*!< Buffer for RX coil signal before FFT */
+            float32_t tx_coil_sig_to_dft[BUFF_TO_DFT_LEN]; 		/*!< Buffer for TX coil signal before FFT */
+        };
+        float32_t packed_sig_to_dft[2 * BUFF_TO_DFT_LEN];		/*!< Interleaved TX/RX samples for the packed transform */
+    };
 
     SIG_FreqDomain_t rx_coil_freq_domain[FREQ_DOMAIN_LEN]; 		/*!< Frequency domain representation of RX coil signal */
     SIG_FreqDomain_t tx_coil_freq_domain[FREQ_DOMAIN_LEN]; 		/*!< Frequency domain representation of TX coil signal */
 
     SIG_PolarForm_t rx_coil_polar[POLAR_FORM_LEN]; 				/*!< Polar form of RX coil frequency domain data */
     SIG_PolarForm_t tx_coil_polar[POLAR_FORM_LEN]; 				/*!< Polar form of TX coil frequency domain data */
+
+    const arm_rfft_fast_instance_f32 *fft_plan;					/*!< Cached FFT instance shared by both coils */
+    const arm_cfft_instance_f32 *cfft_plan;						/*!< Cached complex FFT instance for the packed transform */
+    const float32_t *window;									/*!< Window applied by sig_load_samples(), NULL for rectangular */
+#endif
+    uint16_t dc_offset;											/*!< ADC code subtracted from the samples by sig_load_samples() */
+    WIN_Type_t window_type;										/*!< Window function selected with sig_set_window() */
+    uint16_t fft_len;											/*!< Current FFT length, at most BUFF_TO_DFT_LEN */
+    SIG_TransformMode_t transform_mode;							/*!< Transform used by sig_perform_fft() */
+    SIG_TxMode_t tx_mode;										/*!< Signal driven to the TX coil */
+    float32_t tx_crest_factor;									/*!< Crest factor of the multi-tone TX signal */
+
+    FR_Ring_t frames;											/*!< Descriptors of the completed blocks waiting for the consumer */
+    volatile uint32_t view_sequence;							/*!< Sequence number of the last completed block */
+    volatile uint8_t view_owned[SIG_CAPTURE_BLOCK_COUNT];		/*!< Set while the consumer holds a view of the block */
+    volatile uint8_t view_torn[SIG_CAPTURE_BLOCK_COUNT];		/*!< Set when the DMA wrote into a block while it was held */
+    volatile uint32_t view_overruns;							/*!< Number of views that were overwritten while held */
+    uint32_t view_late;											/*!< Number of views refused because the block was already being overwritten */
+    uint32_t view_max_lag;										/*!< Most blocks completed after a block before it was acquired */
+
+    SIG_ADCRegister_t snapshot[2][SIG_SNAPSHOT_LEN];			/*!< Copies of the start of a view for the time domain chart */
+    volatile uint8_t snapshot_index;							/*!< Index of the snapshot that was written last */
+
+#if SIG_FRONTEND == SIG_FRONTEND_DECIMATE
+    uint32_t raw_sig[2 * SIG_DEC_RAW_BLOCK_LEN];				/*!< Raw ADC samples, two blocks filled by the double-buffered DMA */
+    volatile uint16_t dec_write_index;							/*!< Next input buffer entry the decimator will write */
+#endif
 } SIG_Handle_t;
 
 
 extern SIG_Handle_t sig_handle;  /*!< Global handle for signal processing */
 
+extern SIG_PolarBenchmark_t sig_polar_benchmark_result;  /*!< Result of the last sig_polar_benchmark() call */
+
+extern const uint8_t OUTPUT_MULTITONE_CYCLES[FP_MT_TONE_COUNT];  /*!< Cycles of each multi-tone TX tone per FP_MT_TABLE_LEN samples */
+
 /**
  * @brief Starts the signal processing by initializing ADC and DAC, and starting timers.
  * @param handle Pointer to the SIG_Handle_t structure.
@@ -105,18 +285,102 @@ extern SIG_Handle_t sig_handle;  /*!< Global handle for signal processing */
 void sig_start(SIG_Handle_t *const handle);
 
 /**
- * @brief Loads samples from the ADC buffer into the processing buffers.
+ * @brief Selects the FFT length used by sig_load_samples() and sig_perform_fft().
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param fft_len New FFT length, a power of two supported by the FFT plan cache.
+ * @return SIG_Status_t SIG_OK if the length was applied, SIG_ERROR if it is not supported.
+ */
+SIG_Status_t sig_set_fft_len(SIG_Handle_t *const handle, uint16_t fft_len);
+
+/**
+ * @brief Selects the transform used by sig_load_samples() and sig_perform_fft().
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param mode New transform mode.
+ */
+void sig_set_transform_mode(SIG_Handle_t *const handle, SIG_TransformMode_t mode);
+
+/**
+ * @brief Selects the window applied by sig_load_samples().
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param type New window function.
+ * @return SIG_Status_t SIG_OK if the window was applied, SIG_ERROR if it is not available.
+ */
+SIG_Status_t sig_set_window(SIG_Handle_t *const handle, WIN_Type_t type);
+
+/**
+ * @brief Switches the TX coil between the single-tone and the multi-tone signal.
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param mode New TX mode.
+ */
+void sig_set_tx_mode(SIG_Handle_t *const handle, SIG_TxMode_t mode);
+
+/**
+ * @brief Takes ownership of a completed block of the capture ring.
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param frame Pointer to the FR_Descriptor_t structure popped from the frame ring.
+ * @param view Pointer to the SIG_View_t structure that receives the view.
+ * @return SIG_Status_t SIG_OK if the view is valid, SIG_ERROR if the block is already being overwritten.
+ */
+SIG_Status_t sig_view_acquire(SIG_Handle_t *const handle, const FR_Descriptor_t *const frame, SIG_View_t *const view);
+
+/**
+ * @brief Returns a view to the DMA and reports whether it stayed intact.
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure returned by sig_view_acquire().
+ * @return SIG_Status_t SIG_OK if the samples were not overwritten while the view was held.
+ */
+SIG_Status_t sig_view_release(SIG_Handle_t *const handle, const SIG_View_t *const view);
+
+/**
+ * @brief Copies the start of a view for the time domain chart.
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure holding the samples.
+ */
+void sig_view_snapshot(SIG_Handle_t *const handle, const SIG_View_t *const view);
+
+/**
+ * @brief Loads samples from an ADC buffer view into the processing buffers.
  * @param handle Pointer to the SIG_Handle_t structure.
- * @param flag Flag indicating the ADC conversion status (half or full completion).
+ * @param view Pointer to the SIG_View_t structure holding the samples.
  */
-void sig_load_samples(SIG_Handle_t *const handle, uint8_t flag);
+void sig_load_samples(SIG_Handle_t *const handle, const SIG_View_t *const view);
 
 /**
- * @brief Performs FFT on the loaded signal data and computes magnitude and phase.
+ * @brief Performs FFT on the loaded signal data, the polar form is left to sig_update_polar().
  * @param handle Pointer to the SIG_Handle_t structure.
  * @return Index of the frequency with the maximum magnitude.
  */
 size_t sig_perform_fft(SIG_Handle_t *const handle);
 
+/**
+ * @brief Computes the polar form of a range of frequency bins.
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectra.
+ * @param first Index of the first bin.
+ * @param count Number of bins.
+ */
+void sig_update_polar(SIG_Handle_t *const handle, size_t first, size_t count);
+
+/**
+ * @brief Computes the RX and TX magnitudes and the cross spectrum RX * conj(TX) of the TX frequency bin.
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectra.
+ * @param cross Pointer to the SIG_CrossSpectrum_t structure that receives the values.
+ */
+void sig_cross_spectrum(const SIG_Handle_t *const handle, SIG_CrossSpectrum_t *const cross);
+
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_F32
+/**
+ * @brief Measures the cost of the polar conversion of one bin against all bins.
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectra.
+ * @param result Pointer to the SIG_PolarBenchmark_t structure that receives the cycle counts.
+ */
+void sig_polar_benchmark(SIG_Handle_t *const handle, SIG_PolarBenchmark_t *const result);
+#endif
+
+/**
+ * @brief Returns the index of the next input buffer entry the DMA will write.
+ * @return uint16_t Write index in the range 0..INPUT_BUFF_LEN - 1.
+ */
+uint16_t sig_get_write_index(void);
+
 
 #endif /* INC_SIGNAL_H_ */
@@ -0,0 +1,78 @@
+/**
+ * @file capture.h
+ * @brief Header file for the multi-block ADC capture ring.
+ *
+ * This file contains the declarations for the capture subsystem that streams
+ * the dual ADC samples into a ring of equally sized blocks. The DMA stream
+ * runs in double-buffer mode: while it writes one block through one memory
+ * address register, the other register is pointed at the block after next.
+ * The blocks are therefore filled in ring order, and a completed block stays
+ * intact until the DMA has gone around the whole ring, instead of for only
+ * one block period as with a single circular buffer of two halves.
+ *
+ * An optional tick timer counts the ADC triggers and interrupts once per
+ * given number of samples, so a consumer of shorter pieces than a block can
+ * be woken up without polling the DMA position.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_CAPTURE_H_
+#define SIGNALSPROCESSING_INC_CAPTURE_H_
+
+#include <stdint.h>
+#include "adc.h"
+
+/** @brief Longest wait for the ADC to become ready after it was enabled, in milliseconds. */
+#define CAP_ADC_ENABLE_TIMEOUT_MS          2UL
+
+
+/**
+ * @brief Handle structure for the capture ring.
+ */
+typedef struct
+{
+    ADC_HandleTypeDef *hadc;                /*!< Master ADC whose DMA stream fills the ring */
+    uint32_t *buffer;                       /*!< First word of the ring, one word per dual ADC sample */
+    uint16_t block_len;                     /*!< Number of samples per block */
+    uint8_t block_count;                    /*!< Number of blocks in the ring */
+
+    volatile uint8_t dma_block;             /*!< Block the DMA is writing */
+    volatile uint8_t completed_block;       /*!< Block completed last, valid in HAL_ADC_ConvCpltCallback() */
+    volatile uint32_t completed;            /*!< Number of blocks completed since cap_start() */
+    TIM_HandleTypeDef *tick;                /*!< Tick timer started by cap_tick_start(), NULL before */
+} CAP_Handle_t;
+
+
+extern CAP_Handle_t cap_handle;             /*!< Global handle for the capture ring */
+
+/**
+ * @brief Starts the dual ADC conversions into the capture ring.
+ * @param handle Pointer to the CAP_Handle_t structure.
+ * @param hadc Pointer to the ADC_HandleTypeDef structure of the master ADC.
+ * @param buffer Ring of block_len * block_count words.
+ * @param block_len Number of samples per block.
+ * @param block_count Number of blocks in the ring, at least 2.
+ * @return HAL_StatusTypeDef HAL_OK if the conversions were started.
+ */
+HAL_StatusTypeDef cap_start(CAP_Handle_t *const handle, ADC_HandleTypeDef *hadc, uint32_t *buffer,
+                            uint16_t block_len, uint8_t block_count);
+
+/**
+ * @brief Starts the tick timer that interrupts once per given number of samples.
+ * @param handle Pointer to the CAP_Handle_t structure.
+ * @param htim Pointer to the TIM_HandleTypeDef structure of the tick timer, set up by MX_TIM3_Init().
+ * @param samples Number of samples between two ticks, a divisor of the block length.
+ * @return HAL_StatusTypeDef HAL_OK if the timer was started.
+ */
+HAL_StatusTypeDef cap_tick_start(CAP_Handle_t *const handle, TIM_HandleTypeDef *htim, uint16_t samples);
+
+/**
+ * @brief Returns the index of the next ring entry the DMA will write.
+ * @param handle Pointer to the CAP_Handle_t structure.
+ * @return uint32_t Write index in the range 0..block_len * block_count - 1.
+ */
+uint32_t cap_get_write_index(const CAP_Handle_t *const handle);
+
+#endif /* SIGNALSPROCESSING_INC_CAPTURE_H_ */
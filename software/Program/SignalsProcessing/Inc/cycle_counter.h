@@ -0,0 +1,49 @@
+/**
+ * @file cycle_counter.h
+ * @brief Core cycle counter helpers for profiling the signal chain.
+ *
+ * This file provides inline accessors for the Cortex-M7 DWT cycle counter.
+ * They are used to measure how many CPU cycles the signal processing
+ * stages take, so that different processing paths can be compared.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_CYCLE_COUNTER_H_
+#define SIGNALSPROCESSING_INC_CYCLE_COUNTER_H_
+
+#include <stdint.h>
+#include "main.h"
+
+/** @brief Key that unlocks write access to the DWT registers on the Cortex-M7. */
+#define CC_DWT_UNLOCK_KEY                  0xC5ACCE55UL
+
+
+/**
+ * @brief Enables the DWT cycle counter.
+ *
+ * Must be called once before cc_get() is used.
+ */
+static inline void cc_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = CC_DWT_UNLOCK_KEY;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Returns the current value of the DWT cycle counter.
+ *
+ * The counter wraps around every 2^32 cycles, so intervals must be
+ * computed with unsigned subtraction.
+ *
+ * @return uint32_t Current cycle count.
+ */
+static inline uint32_t cc_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+#endif /* SIGNALSPROCESSING_INC_CYCLE_COUNTER_H_ */
@@ -0,0 +1,106 @@
+/**
+ * @file deadline_monitor.h
+ * @brief Header file for the run-time deadline monitor of the signal pipeline.
+ *
+ * This file contains the declarations for the monitor that checks whether the
+ * signal processing task keeps up with the ADC. Every processed frame is
+ * recorded with the cycle counter value of its release, when the DMA completed
+ * the block, of the start of its processing and of the end of the detection.
+ * The monitor keeps the latency from release to detection in a histogram,
+ * together with its minimum, average and maximum, the processing time and
+ * the number of frames that missed their deadline. Recording a frame takes a
+ * few dozen cycles, so the monitor stays enabled in every build.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_DEADLINE_MONITOR_H_
+#define SIGNALSPROCESSING_INC_DEADLINE_MONITOR_H_
+
+#include <stdint.h>
+
+/** @brief Number of latency histogram bins, the last one collects every latency of two periods or more. */
+#define DM_HIST_BINS                       64
+
+/** @brief Number of histogram bins per deadline period. */
+#define DM_BINS_PER_PERIOD                 ( DM_HIST_BINS / 2 )
+
+/** @brief Percentile of the latency reported by dm_get_stats(). */
+#define DM_PERCENTILE                      99
+
+
+/**
+ * @brief Handle structure for the deadline monitor.
+ *
+ * The statistics are written by the signal processing task only. The version
+ * is odd while a record is being written, so a reader of lower priority can
+ * tell that its copy was interrupted and repeat it.
+ */
+typedef struct
+{
+    uint32_t period;                            /*!< Deadline of a frame after its release, in CPU cycles */
+    uint32_t bin_width;                         /*!< Latency covered by one histogram bin, in CPU cycles */
+
+    uint32_t histogram[DM_HIST_BINS];           /*!< Number of frames per latency bin */
+    uint32_t count;                             /*!< Number of recorded frames */
+    uint32_t misses;                            /*!< Number of frames that completed after their deadline */
+    uint32_t min_latency;                       /*!< Shortest latency, in CPU cycles */
+    uint32_t max_latency;                       /*!< Longest latency, in CPU cycles */
+    uint64_t latency_sum;                       /*!< Sum of all latencies, in CPU cycles */
+    uint64_t busy_sum;                          /*!< Sum of all processing times, in CPU cycles */
+
+    volatile uint32_t version;                  /*!< Number of started and completed records */
+    volatile uint8_t reset_request;             /*!< Set by dm_reset(), the statistics are cleared with the next record */
+} DM_Handle_t;
+
+
+/**
+ * @brief Statistics of the recorded frames, in microseconds.
+ */
+typedef struct
+{
+    uint32_t period_us;             /*!< Deadline of a frame after its release */
+    uint32_t count;                 /*!< Number of recorded frames */
+    uint32_t misses;                /*!< Number of frames that completed after their deadline */
+    uint32_t min_us;                /*!< Shortest latency */
+    uint32_t avg_us;                /*!< Average latency */
+    uint32_t max_us;                /*!< Longest latency */
+    uint32_t p99_us;                /*!< Latency not exceeded by DM_PERCENTILE percent of the frames, to one bin width */
+    uint32_t avg_busy_us;           /*!< Average processing time */
+    uint32_t load_percent;          /*!< Average processing time relative to the period */
+} DM_Stats_t;
+
+
+extern DM_Handle_t dm_handle;       /*!< Global deadline monitor of the signal processing task */
+
+/**
+ * @brief Sets the deadline and clears the statistics.
+ * @param handle Pointer to the DM_Handle_t structure.
+ * @param period_cycles Deadline of a frame after its release, in CPU cycles.
+ */
+void dm_init(DM_Handle_t *const handle, uint32_t period_cycles);
+
+/**
+ * @brief Records one processed frame, to be called by the signal processing task only.
+ * @param handle Pointer to the DM_Handle_t structure.
+ * @param release Cycle counter value when the frame became available.
+ * @param start Cycle counter value when its processing started.
+ * @param end Cycle counter value when its processing ended.
+ */
+void dm_record(DM_Handle_t *const handle, uint32_t release, uint32_t start, uint32_t end);
+
+/**
+ * @brief Requests the statistics to be cleared with the next record.
+ * @param handle Pointer to the DM_Handle_t structure.
+ */
+void dm_reset(DM_Handle_t *const handle);
+
+/**
+ * @brief Returns a consistent copy of the statistics, to be called from a task of lower priority than the writer.
+ * @param handle Pointer to the DM_Handle_t structure.
+ * @param stats Pointer to the DM_Stats_t structure that receives the statistics.
+ */
+void dm_get_stats(const DM_Handle_t *const handle, DM_Stats_t *const stats);
+
+#endif /* SIGNALSPROCESSING_INC_DEADLINE_MONITOR_H_ */
@@ -0,0 +1,129 @@
+/**
+ * @file decimator.h
+ * @brief Header file for the CIC and polyphase FIR decimator of the acquisition front-end.
+ *
+ * This file contains the declarations for the decimator that reduces the raw
+ * dual ADC stream of the decimating front-end to the analysis rate. A CIC
+ * filter of order DEC_CIC_ORDER first decimates by DEC_CIC_RATIO with
+ * additions only, then a linear phase FIR filter decimates by 2 more. The
+ * FIR filter also compensates the droop of the CIC filter in the passband.
+ * It is split into its two polyphase branches, so it is only evaluated at the
+ * output rate. The output codes carry DEC_EXTRA_BITS more bits than the ADC
+ * codes, which keeps the noise reduction of the averaging. The response is
+ * bounded by DEC_PASS_RIPPLE_DB, DEC_STOP_ATTENUATION_DB and
+ * DEC_ALIAS_ATTENUATION_DB, which the host tests check together with the
+ * equality to a direct convolution.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_DECIMATOR_H_
+#define SIGNALSPROCESSING_INC_DECIMATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "signal_config.h"
+
+/** @brief Order of the CIC filter (number of integrator and comb stages). */
+#define DEC_CIC_ORDER                      3
+
+/** @brief Decimation ratio of the CIC filter, the FIR filter decimates by 2. */
+#define DEC_CIC_RATIO                      ( SIG_DECIMATION / 2 )
+
+#if SIG_DECIMATION == 2
+/** @brief Gain of the CIC filter as a power of two, DEC_CIC_RATIO ^ DEC_CIC_ORDER. */
+#define DEC_CIC_GAIN_BITS                  0
+#elif SIG_DECIMATION == 4
+/** @brief Gain of the CIC filter as a power of two, DEC_CIC_RATIO ^ DEC_CIC_ORDER. */
+#define DEC_CIC_GAIN_BITS                  3
+#elif SIG_DECIMATION == 8
+/** @brief Gain of the CIC filter as a power of two, DEC_CIC_RATIO ^ DEC_CIC_ORDER. */
+#define DEC_CIC_GAIN_BITS                  6
+#else
+#error "SIG_DECIMATION must be 2, 4 or 8"
+#endif
+
+/** @brief Number of FIR filter taps (even, split evenly between both polyphase branches). */
+#define DEC_FIR_LEN                        24
+
+/** @brief Number of taps per polyphase branch. */
+#define DEC_PHASE_LEN                      ( DEC_FIR_LEN / 2 )
+
+/** @brief Number of fraction bits of the FIR coefficients. */
+#define DEC_COEFF_FRAC_BITS                15
+
+/** @brief Number of bits the output codes carry beyond the 12-bit ADC codes. */
+#define DEC_EXTRA_BITS                     2
+
+/** @brief Largest output code. */
+#define DEC_OUTPUT_MAX                     ( ( 4096 << DEC_EXTRA_BITS ) - 1 )
+
+/** @brief End of the flat passband relative to the output rate. */
+#define DEC_PASS_EDGE                      0.2f
+
+/** @brief Start of the stopband relative to the output rate, the output Nyquist frequency. */
+#define DEC_STOP_EDGE                      0.5f
+
+/** @brief Largest deviation from unity gain up to DEC_PASS_EDGE, in dB. */
+#define DEC_PASS_RIPPLE_DB                 1.0f
+
+/** @brief Smallest attenuation from DEC_STOP_EDGE up to the raw Nyquist frequency, in dB. */
+#define DEC_STOP_ATTENUATION_DB            20.0f
+
+/** @brief Smallest attenuation of the stopband frequencies that alias into the passband, in dB. */
+#define DEC_ALIAS_ATTENUATION_DB           40.0f
+
+/** @brief Number of frequency points used to design the FIR filter. */
+#define DEC_DESIGN_POINTS                  128
+
+
+/**
+ * @brief State of one ADC channel.
+ *
+ * The integrators and combs run modulo 2^32, the result of the last comb is
+ * exact as long as it fits, which the CIC gain guarantees. Each delay line
+ * holds the intermediate samples of one polyphase branch twice, so the
+ * newest DEC_PHASE_LEN samples always lie next to each other.
+ */
+typedef struct
+{
+    uint32_t integrator[DEC_CIC_ORDER];                 /*!< CIC integrator stages at the raw rate */
+    uint32_t comb[DEC_CIC_ORDER];                       /*!< Previous input of every CIC comb stage */
+    int32_t even_line[2 * DEC_PHASE_LEN];               /*!< Intermediate samples 2p, 2p - 2, ... for output p */
+    int32_t odd_line[2 * DEC_PHASE_LEN];                /*!< Intermediate samples 2p + 1, 2p - 1, ... for output p */
+} DEC_Channel_t;
+
+
+/**
+ * @brief Handle structure for the decimator of both ADC channels.
+ */
+typedef struct
+{
+    int16_t taps[DEC_FIR_LEN];                          /*!< FIR coefficients h[0..DEC_FIR_LEN-1] in Q15 */
+    int16_t even_taps[DEC_PHASE_LEN];                   /*!< h[1], h[3], ..., applied to the even intermediate samples */
+    int16_t odd_taps[DEC_PHASE_LEN];                    /*!< h[0], h[2], ..., applied to the odd intermediate samples */
+
+    DEC_Channel_t channel[2];                           /*!< State of ADC1 (low half-word) and ADC2 (high half-word) */
+    uint8_t line_index;                                 /*!< Position of the newest sample in the delay lines */
+} DEC_Handle_t;
+
+
+extern DEC_Handle_t dec_handle;                         /*!< Global decimator of the acquisition front-end */
+
+/**
+ * @brief Designs the FIR filter and clears the filter state.
+ * @param handle Pointer to the DEC_Handle_t structure.
+ */
+void dec_init(DEC_Handle_t *const handle);
+
+/**
+ * @brief Decimates a block of raw dual ADC samples.
+ * @param handle Pointer to the DEC_Handle_t structure.
+ * @param src Raw samples, ADC1 in the low and ADC2 in the high half-word.
+ * @param dst Output samples in the same format, len / SIG_DECIMATION words.
+ * @param len Number of raw samples, a multiple of SIG_DECIMATION.
+ */
+void dec_process(DEC_Handle_t *const handle, const uint32_t *src, uint32_t *dst, size_t len);
+
+#endif /* SIGNALSPROCESSING_INC_DECIMATOR_H_ */
@@ -0,0 +1,120 @@
+/**
+ * @file discrimination.h
+ * @brief Header file for the target discrimination.
+ *
+ * This file contains the declarations for the discrimination that sorts a
+ * detected target into a class by its phase difference and decides whether
+ * it is reported. The class of every phase is looked up in a table built
+ * once by ds_init(), and every preset is an accept mask over the classes, so
+ * classifying a target and switching or editing a preset take constant time
+ * and never touch the table.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_DISCRIMINATION_H_
+#define SIGNALSPROCESSING_INC_DISCRIMINATION_H_
+
+#include <stdint.h>
+
+/** @brief Number of entries of the phase table, one per degree from -180 to 179. */
+#define DS_TABLE_LEN                       360
+
+
+/**
+ * @brief Target class given by the phase difference.
+ */
+typedef enum
+{
+    DS_CLASS_FERROUS = 0,           /*!< Iron and steel */
+    DS_CLASS_FOIL,                  /*!< Foil and very small targets */
+    DS_CLASS_LOW,                   /*!< Low conductors such as nickel and pull tabs */
+    DS_CLASS_MID,                   /*!< Medium conductors such as zinc and brass */
+    DS_CLASS_HIGH,                  /*!< High conductors such as copper and silver */
+    DS_CLASS_COUNT                  /*!< Number of classes */
+} DS_Class_t;
+
+
+/**
+ * @brief Accept mask selected for the audio.
+ */
+typedef enum
+{
+    DS_PRESET_ALL_METAL = 0,        /*!< Every class is accepted */
+    DS_PRESET_NO_FERROUS,           /*!< Every class but ferrous is accepted */
+    DS_PRESET_COINS,                /*!< Only medium and high conductors are accepted */
+    DS_PRESET_CUSTOM,               /*!< Mask edited with ds_set_notch() */
+    DS_PRESET_COUNT                 /*!< Number of presets */
+} DS_Preset_t;
+
+
+/**
+ * @brief Phase range that belongs to one class.
+ */
+typedef struct
+{
+    int16_t upper;                  /*!< Highest phase difference of the range in degrees, the range starts above the previous one */
+    DS_Class_t target_class;        /*!< Class of the range */
+} DS_Range_t;
+
+
+/**
+ * @brief Handle structure for the discrimination.
+ *
+ * The table is only written by ds_init(). The masks and the preset are
+ * written by the GUI task and read by the signal processing task, each with
+ * a single word access.
+ */
+typedef struct
+{
+    uint8_t classes[DS_TABLE_LEN];              /*!< Class of the phase difference p in classes[p + 180] */
+    volatile uint32_t masks[DS_PRESET_COUNT];   /*!< Accept mask of every preset, bit c accepts class c */
+    volatile DS_Preset_t preset;                /*!< Active preset */
+} DS_Handle_t;
+
+
+extern DS_Handle_t ds_handle;                                   /*!< Global handle for the discrimination */
+
+extern const char *const ds_class_names[DS_CLASS_COUNT];       /*!< Short name of every class */
+
+extern const char *const ds_preset_names[DS_PRESET_COUNT];     /*!< Short name of every preset */
+
+/**
+ * @brief Builds the phase table, the presets keep their masks.
+ * @param handle Pointer to the DS_Handle_t structure.
+ */
+void ds_init(DS_Handle_t *const handle);
+
+/**
+ * @brief Returns the class of a phase difference.
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param phase_difference Phase difference in degrees, as reported by md_detect().
+ * @return DS_Class_t Class of the phase difference.
+ */
+DS_Class_t ds_classify(const DS_Handle_t *const handle, int16_t phase_difference);
+
+/**
+ * @brief Returns whether a class is accepted by the active preset.
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param target_class Class of the target.
+ * @return uint8_t 1 if the class is accepted, 0 if it is notched out.
+ */
+uint8_t ds_accept(const DS_Handle_t *const handle, DS_Class_t target_class);
+
+/**
+ * @brief Selects the active preset.
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param preset Preset to be used from the next detection on.
+ */
+void ds_set_preset(DS_Handle_t *const handle, DS_Preset_t preset);
+
+/**
+ * @brief Accepts or notches out one class in the custom preset and selects it.
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param target_class Class to be changed.
+ * @param accept 1 to accept the class, 0 to notch it out.
+ */
+void ds_set_notch(DS_Handle_t *const handle, DS_Class_t target_class, uint8_t accept);
+
+#endif /* SIGNALSPROCESSING_INC_DISCRIMINATION_H_ */
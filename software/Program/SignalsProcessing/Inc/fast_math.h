@@ -0,0 +1,62 @@
+/**
+ * @file fast_math.h
+ * @brief Fast approximations of the transcendental functions used by the signal chain.
+ *
+ * This file provides inline replacements for library functions whose full
+ * accuracy is not needed, so they can be evaluated per FFT bin without
+ * dominating the processing time.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_FAST_MATH_H_
+#define SIGNALSPROCESSING_INC_FAST_MATH_H_
+
+#include "arm_math.h"
+
+
+/**
+ * @brief Computes atan2(y, x) with a maximum error of 1.2e-5 rad.
+ *
+ * The argument is reduced to z = min(|x|, |y|) / max(|x|, |y|) in [0, 1],
+ * where atan(z) is evaluated with the degree 9 polynomial from Abramowitz and
+ * Stegun 4.4.49, and the octant is restored afterwards. Only one division and
+ * no library call is needed, compared with atan2f() from the C library.
+ * atan2(0, 0) returns 0.
+ *
+ * @param y Imaginary part.
+ * @param x Real part.
+ * @return float32_t Angle in radians, in the range -pi..pi.
+ */
+static inline float32_t fm_atan2f(float32_t y, float32_t x)
+{
+    float32_t abs_x = fabsf(x);
+    float32_t abs_y = fabsf(y);
+    float32_t max = (abs_x > abs_y) ? abs_x : abs_y;
+    float32_t min = (abs_x > abs_y) ? abs_y : abs_x;
+    float32_t z = 0, z2 = 0, angle = 0;
+
+    if (max == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    z = min / max;
+    z2 = z * z;
+    angle = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+
+    /* Restore the octant */
+    if (abs_y > abs_x)
+    {
+        angle = (PI / 2.0f) - angle;
+    }
+    if (x < 0.0f)
+    {
+        angle = PI - angle;
+    }
+
+    return (y < 0.0f) ? -angle : angle;
+}
+
+#endif /* SIGNALSPROCESSING_INC_FAST_MATH_H_ */
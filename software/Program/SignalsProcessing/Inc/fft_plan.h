@@ -0,0 +1,103 @@
+/**
+ * @file fft_plan.h
+ * @brief Header file for the FFT plan cache.
+ *
+ * This file contains the declarations for the cache of real and complex FFT
+ * instances. Every supported transform length is initialized once at startup, and the
+ * signal processing code only looks up the ready instance, so the transform
+ * length can be switched at runtime without calling arm_rfft_fast_init_f32().
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_FFT_PLAN_H_
+#define SIGNALSPROCESSING_INC_FFT_PLAN_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "signal_config.h"
+
+/** @brief Base-2 logarithm of the shortest supported transform length. */
+#define FFT_PLAN_MIN_LEN_LOG2              5
+
+/** @brief Base-2 logarithm of the longest supported transform length. */
+#define FFT_PLAN_MAX_LEN_LOG2              10
+
+/** @brief Shortest supported transform length. */
+#define FFT_PLAN_MIN_LEN                   ( 1U << FFT_PLAN_MIN_LEN_LOG2 )
+
+/** @brief Longest supported transform length. */
+#define FFT_PLAN_MAX_LEN                   ( 1U << FFT_PLAN_MAX_LEN_LOG2 )
+
+/** @brief Number of cached transform lengths. */
+#define FFT_PLAN_COUNT                     ( FFT_PLAN_MAX_LEN_LOG2 - FFT_PLAN_MIN_LEN_LOG2 + 1 )
+
+
+/**
+ * @brief Structure holding one initialized real and complex FFT instance per supported length.
+ */
+typedef struct
+{
+    arm_rfft_fast_instance_f32 rfft[FFT_PLAN_COUNT];    /*!< Real FFT instances, index 0 is FFT_PLAN_MIN_LEN */
+    arm_cfft_instance_f32 cfft[FFT_PLAN_COUNT];         /*!< Complex FFT instances, index 0 is FFT_PLAN_MIN_LEN */
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+    arm_rfft_instance_q15 rfft_q15[FFT_PLAN_COUNT];     /*!< Q15 real FFT instances, index 0 is FFT_PLAN_MIN_LEN */
+#endif
+} FFT_PlanCache_t;
+
+/**
+ * @brief Cycle counts of creating the FFT instances per frame and of looking them up in the cache.
+ */
+typedef struct
+{
+    uint32_t init_cycles;                               /*!< Cycles of two arm_rfft_fast_init_f32() calls */
+    uint32_t lookup_cycles;                             /*!< Cycles of two fft_plan_get() calls */
+} FFT_PlanBenchmark_t;
+
+
+extern FFT_PlanCache_t fft_plan_cache;                  /*!< Global FFT plan cache */
+
+extern FFT_PlanBenchmark_t fft_plan_benchmark_result;   /*!< Result of the last fft_plan_benchmark() call */
+
+/**
+ * @brief Initializes the FFT instances for all supported transform lengths.
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ */
+void fft_plan_init(FFT_PlanCache_t *const cache);
+
+/**
+ * @brief Returns the cached real FFT instance for the given transform length.
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Transform length, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const arm_rfft_fast_instance_f32* Cached instance, or NULL if the length is not supported.
+ */
+const arm_rfft_fast_instance_f32 *fft_plan_get(const FFT_PlanCache_t *const cache, uint16_t fft_len);
+
+/**
+ * @brief Returns the cached complex FFT instance for the given transform length.
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Number of complex points, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const arm_cfft_instance_f32* Cached instance, or NULL if the length is not supported.
+ */
+const arm_cfft_instance_f32 *fft_plan_get_cfft(const FFT_PlanCache_t *const cache, uint16_t fft_len);
+
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+/**
+ * @brief Returns the cached Q15 real FFT instance for the given transform length.
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Transform length, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const arm_rfft_instance_q15* Cached instance, or NULL if the length is not supported.
+ */
+const arm_rfft_instance_q15 *fft_plan_get_q15(const FFT_PlanCache_t *const cache, uint16_t fft_len);
+#endif
+
+/**
+ * @brief Measures the per-frame cost of creating the FFT instances against looking them up.
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Transform length used for the measurement.
+ * @param result Pointer to the FFT_PlanBenchmark_t structure that receives the cycle counts.
+ */
+void fft_plan_benchmark(const FFT_PlanCache_t *const cache, uint16_t fft_len, FFT_PlanBenchmark_t *const result);
+
+#endif /* SIGNALSPROCESSING_INC_FFT_PLAN_H_ */
@@ -0,0 +1,102 @@
+/**
+ * @file frame_ring.h
+ * @brief Header file for the lock-free ring of ADC frame descriptors.
+ *
+ * This file contains the declarations for the single-producer single-consumer
+ * ring that hands completed ADC frames from the ADC interrupts to the signal
+ * processing task. Every descriptor carries a sequence number, so the consumer
+ * can tell how many frames were lost, and the ring counts every frame it could
+ * not accept instead of dropping it silently.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_FRAME_RING_H_
+#define SIGNALSPROCESSING_INC_FRAME_RING_H_
+
+#include <stdint.h>
+
+/** @brief Number of descriptors the ring can hold (must be a power of two). */
+#define FR_RING_LEN                        8
+
+/** @brief Thread flag set on the consumer task whenever a descriptor was pushed. */
+#define FR_THREAD_FLAG                     0x0001U
+
+#if ( FR_RING_LEN & (FR_RING_LEN - 1) ) != 0
+#error "FR_RING_LEN must be a power of two"
+#endif
+
+
+/**
+ * @brief Status of a ring operation.
+ */
+typedef enum
+{
+    FR_OK = 0,                      /*!< A descriptor was pushed or popped */
+    FR_FULL,                        /*!< The ring is full, the descriptor was dropped */
+    FR_EMPTY                        /*!< The ring holds no descriptor */
+} FR_Status_t;
+
+
+/**
+ * @brief Description of one completed ADC frame.
+ */
+typedef struct
+{
+    uint32_t sequence;              /*!< Number of frames completed before and including this one */
+    uint32_t timestamp;             /*!< Cycle counter value when the DMA completed the frame */
+    uint8_t block;                  /*!< Index of the completed block in the capture ring */
+} FR_Descriptor_t;
+
+
+/**
+ * @brief Handle structure for the frame descriptor ring.
+ *
+ * The write index is only written by the producer and the read index only by
+ * the consumer. Both run freely and are masked on access, so a full and an
+ * empty ring can be told apart without a lock.
+ */
+typedef struct
+{
+    FR_Descriptor_t slots[FR_RING_LEN];         /*!< Descriptor storage */
+    volatile uint32_t write_index;              /*!< Number of descriptors pushed, written by the producer */
+    volatile uint32_t read_index;               /*!< Number of descriptors popped, written by the consumer */
+
+    volatile uint32_t drops;                    /*!< Frames dropped by the producer because the ring was full */
+    uint32_t gaps;                              /*!< Frames missing between two popped sequence numbers */
+    uint32_t max_depth;                         /*!< Largest number of descriptors waiting at a pop */
+    uint32_t last_sequence;                     /*!< Sequence number of the last popped descriptor */
+} FR_Ring_t;
+
+
+/**
+ * @brief Empties the ring and clears its counters.
+ * @param ring Pointer to the FR_Ring_t structure.
+ */
+void fr_init(FR_Ring_t *const ring);
+
+/**
+ * @brief Appends a descriptor, to be called by the producer only.
+ * @param ring Pointer to the FR_Ring_t structure.
+ * @param frame Pointer to the descriptor to be copied into the ring.
+ * @return FR_Status_t FR_OK if the descriptor was queued, FR_FULL if it was dropped.
+ */
+FR_Status_t fr_push(FR_Ring_t *const ring, const FR_Descriptor_t *const frame);
+
+/**
+ * @brief Removes the oldest descriptor, to be called by the consumer only.
+ * @param ring Pointer to the FR_Ring_t structure.
+ * @param frame Pointer to the FR_Descriptor_t structure that receives the descriptor.
+ * @return FR_Status_t FR_OK if a descriptor was returned, FR_EMPTY otherwise.
+ */
+FR_Status_t fr_pop(FR_Ring_t *const ring, FR_Descriptor_t *const frame);
+
+/**
+ * @brief Returns the number of descriptors waiting in the ring.
+ * @param ring Pointer to the FR_Ring_t structure.
+ * @return uint32_t Number of queued descriptors.
+ */
+uint32_t fr_depth(const FR_Ring_t *const ring);
+
+#endif /* SIGNALSPROCESSING_INC_FRAME_RING_H_ */
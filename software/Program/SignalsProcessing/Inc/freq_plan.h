@@ -0,0 +1,117 @@
+/**
+ * @file freq_plan.h
+ * @brief Coherent sampling frequency plan of the TX, audio and ADC signals.
+ *
+ * This file derives every frequency related constant from a few targets.
+ * The DAC tables and the ADC are clocked by the same TIM2 update event, so
+ * the TX frequency is exactly the sample rate divided by the TX table length.
+ * The TX table length is a power of two that divides the analysis block
+ * length, so the TX frequency always falls exactly on FFT bin
+ * FP_TX_BIN(len) and every block holds a whole number of TX periods.
+ * To change the operating frequency only the targets below are edited,
+ * the timer period, the table lengths and the tables follow. The multi-tone
+ * TX signal repeats every FP_MT_TABLE_LEN samples, so all of its tones are
+ * coherent with the analysis block as well. With the decimating front-end
+ * TIM2 runs FP_DECIMATION times faster than the analysis rate, so the DAC
+ * tables are FP_DECIMATION times longer than the periods they hold.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_FREQ_PLAN_H_
+#define SIGNALSPROCESSING_INC_FREQ_PLAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "signal_config.h"
+
+/** @brief Input clock of TIM2 in Hz. */
+#define FP_TIMER_CLOCK_HZ                  275000000UL
+
+/** @brief Requested TX coil frequency in Hz. */
+#define FP_TX_TARGET_HZ                    18750UL
+
+/** @brief Number of samples in one TX period (power of two dividing FP_BLOCK_LEN). */
+#define FP_TX_TABLE_LEN                    8
+
+/** @brief Requested frequency of the audio tone in Hz. */
+#define FP_AUDIO_TARGET_HZ                 1875UL
+
+/** @brief Number of samples analysed per block (power of two). */
+#define FP_BLOCK_LEN                       1024
+
+#if SIG_FRONTEND == SIG_FRONTEND_DECIMATE
+/** @brief Number of raw ADC samples per analysed sample. */
+#define FP_DECIMATION                      SIG_DECIMATION
+#else
+/** @brief Number of raw ADC samples per analysed sample. */
+#define FP_DECIMATION                      1
+#endif
+
+/** @brief TIM2 period in timer clocks, the closest one to the TX target. */
+#define FP_TIM_PERIOD                      ( ( FP_TIMER_CLOCK_HZ + ( FP_TX_TARGET_HZ * FP_TX_TABLE_LEN * FP_DECIMATION ) / 2 ) / ( FP_TX_TARGET_HZ * FP_TX_TABLE_LEN * FP_DECIMATION ) )
+
+/** @brief Sample rate of the analysed samples in Hz, FP_DECIMATION times below the ADC and DAC rate. */
+#define FP_SAMPLE_RATE_HZ                  ( (float)FP_TIMER_CLOCK_HZ / ( (float)FP_TIM_PERIOD * (float)FP_DECIMATION ) )
+
+/** @brief Actual TX coil frequency in Hz. */
+#define FP_TX_FREQ_HZ                      ( FP_SAMPLE_RATE_HZ / (float)FP_TX_TABLE_LEN )
+
+/** @brief Number of DAC samples in one TX period. */
+#define FP_DAC_TX_TABLE_LEN                ( FP_TX_TABLE_LEN * FP_DECIMATION )
+
+/** @brief Number of DAC samples in one period of the audio tone. */
+#define FP_AUDIO_TABLE_LEN                 ( ( FP_TIMER_CLOCK_HZ / FP_TIM_PERIOD + FP_AUDIO_TARGET_HZ / 2 ) / FP_AUDIO_TARGET_HZ )
+
+/** @brief FFT bin of the TX frequency for a transform of the given length. */
+#define FP_TX_BIN(len)                     ( (len) / FP_TX_TABLE_LEN )
+
+/** @brief Maximum value of the DAC input (12-bit resolution). */
+#define FP_DAC_MAX_VALUE                   4095
+
+/** @brief DAC code around which the generated signals swing. */
+#define FP_DAC_MID_SCALE                   2048
+
+/** @brief Amplitude of the TX signal in DAC codes. */
+#define FP_TX_AMPLITUDE                    1950
+
+/** @brief Amplitude of the audio signal in DAC codes. */
+#define FP_AUDIO_AMPLITUDE                 2047
+
+/** @brief Number of samples in one period of the multi-tone TX signal (power of two dividing FP_BLOCK_LEN). */
+#define FP_MT_TABLE_LEN                    64
+
+/** @brief Number of DAC samples in one period of the multi-tone TX signal. */
+#define FP_DAC_MT_TABLE_LEN                ( FP_MT_TABLE_LEN * FP_DECIMATION )
+
+/** @brief Number of tones in the multi-tone TX signal. */
+#define FP_MT_TONE_COUNT                   3
+
+/** @brief Cycles of each tone per multi-tone period, the first tone is the single-tone TX frequency. */
+#define FP_MT_TONE_CYCLES                  { FP_MT_TABLE_LEN / FP_TX_TABLE_LEN, 4, 12 }
+
+/** @brief Peak amplitude of the summed multi-tone TX signal in DAC codes. */
+#define FP_MT_PEAK_AMPLITUDE               1950
+
+
+/**
+ * @brief Fills a table with one period of a sine wave in DAC codes.
+ * @param table Pointer to the table to be filled.
+ * @param len Number of entries in the table.
+ * @param amplitude Amplitude in DAC codes.
+ */
+void fp_generate_sine(uint32_t *const table, size_t len, uint32_t amplitude);
+
+/**
+ * @brief Fills a table with one period of the sum of several equal-amplitude tones in DAC codes.
+ * @param table Pointer to the table to be filled.
+ * @param len Number of entries in the table.
+ * @param cycles Cycles of each tone per table period.
+ * @param count Number of tones.
+ * @param peak_amplitude Peak amplitude of the sum in DAC codes.
+ * @return float Crest factor (peak / RMS) of the generated signal.
+ */
+float fp_generate_multitone(uint32_t *const table, size_t len, const uint8_t *const cycles, size_t count, uint32_t peak_amplitude);
+
+#endif /* SIGNALSPROCESSING_INC_FREQ_PLAN_H_ */
@@ -0,0 +1,117 @@
+/**
+ * @file ground_balance.h
+ * @brief Header file for the automatic ground balance.
+ *
+ * This file contains the declarations for the one-touch ground balance. On
+ * request it captures the RX vector referenced to the TX phase over
+ * GB_CAPTURE_MS while the coil is pumped over the ground, finds the direction
+ * in which the ground moves it, and from then on removes the component along
+ * that direction from the magnitude every detection is based on. The cross
+ * spectrum keeps the ground, so the phase of a target is not forced onto
+ * the perpendicular of the ground. The capture runs in the signal
+ * processing task, so the GUI only posts the request and polls the progress.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_GROUND_BALANCE_H_
+#define SIGNALSPROCESSING_INC_GROUND_BALANCE_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "metal_detecting.h"
+
+/** @brief Duration of the ground capture in milliseconds. */
+#define GB_CAPTURE_MS                      2000.0f
+
+/** @brief RMS spread of the captured vectors below which the pumping is taken as too weak, in RX magnitude units. */
+#define GB_MIN_SPREAD                      1.0f
+
+
+/**
+ * @brief State of the ground balance.
+ */
+typedef enum
+{
+    GB_OFF = 0,                     /*!< No ground balance was captured, the results pass unchanged */
+    GB_CAPTURING,                   /*!< The ground is being captured, the previous balance still applies */
+    GB_BALANCED                     /*!< The ground component is removed from every result */
+} GB_State_t;
+
+
+/**
+ * @brief Ground direction and capture sums of one tone.
+ *
+ * The sums are taken relative to the first captured vector, so the
+ * covariance does not suffer from cancellation when the ground response is
+ * large compared with its variation.
+ */
+typedef struct
+{
+    float32_t ground_real;                      /*!< Real part of the unit vector of the ground direction */
+    float32_t ground_imag;                      /*!< Imaginary part of the unit vector of the ground direction */
+
+    float32_t origin_real;                      /*!< Real part of the first captured vector */
+    float32_t origin_imag;                      /*!< Imaginary part of the first captured vector */
+    float32_t sum_real;                         /*!< Sum of the real deviations from the origin */
+    float32_t sum_imag;                         /*!< Sum of the imaginary deviations from the origin */
+    float32_t sum_real_real;                    /*!< Sum of the squared real deviations */
+    float32_t sum_imag_imag;                    /*!< Sum of the squared imaginary deviations */
+    float32_t sum_real_imag;                    /*!< Sum of the products of the real and imaginary deviations */
+} GB_Channel_t;
+
+
+/**
+ * @brief Handle structure for the ground balance.
+ *
+ * channel[0] belongs to the primary tone and channel[t + 1] to tone t of the
+ * multi-tone mode, as the ground phase depends on the frequency. Only
+ * requests and state are shared with the GUI task.
+ */
+typedef struct
+{
+    GB_Channel_t channel[MD_MAX_TONES + 1];     /*!< Ground direction and capture sums of the primary tone and of every tone */
+    uint32_t capture_frames;                    /*!< Number of results in a capture */
+    uint32_t captured;                          /*!< Number of results captured so far */
+    uint32_t served;                            /*!< Number of requests that started a capture */
+    uint8_t capture_tones;                      /*!< Number of multi-tone tones in the running capture */
+    uint8_t balanced_tones;                     /*!< Number of multi-tone tones with a captured ground direction */
+    uint8_t grounded;                           /*!< 1 once a ground direction was captured */
+    volatile uint32_t requests;                 /*!< Number of captures requested by gb_start() */
+    volatile GB_State_t state;                  /*!< Current state */
+    volatile int16_t ground_phase;              /*!< Phase of the ground direction of the primary tone in degrees, -90..90 */
+} GB_Handle_t;
+
+
+extern GB_Handle_t gb_handle;                   /*!< Global handle for the ground balance */
+
+/**
+ * @brief Initializes the ground balance without a balance.
+ * @param handle Pointer to the GB_Handle_t structure.
+ * @param update_period_ms Time between two results in milliseconds.
+ */
+void gb_init(GB_Handle_t *const handle, float32_t update_period_ms);
+
+/**
+ * @brief Requests a new ground capture, returns immediately.
+ * @param handle Pointer to the GB_Handle_t structure.
+ */
+void gb_start(GB_Handle_t *const handle);
+
+/**
+ * @brief Returns the progress of the running capture.
+ * @param handle Pointer to the GB_Handle_t structure.
+ * @return uint8_t Progress in percent, 0 if no capture runs.
+ */
+uint8_t gb_progress(const GB_Handle_t *const handle);
+
+/**
+ * @brief Captures a result if requested and removes the ground component from its magnitudes.
+ * @param handle Pointer to the GB_Handle_t structure.
+ * @param data Pointer to the MD_Data_t structure of the result, its magnitudes and ground direction are overwritten.
+ * @return uint8_t 1 if a new ground balance took effect with this result, 0 otherwise.
+ */
+uint8_t gb_update(GB_Handle_t *const handle, MD_Data_t *const data);
+
+#endif /* SIGNALSPROCESSING_INC_GROUND_BALANCE_H_ */
@@ -0,0 +1,99 @@
+/**
+ * @file iq_demod.h
+ * @brief Header file for the single-bin synchronous I/Q demodulator.
+ *
+ * This file contains the declarations for the I/Q demodulation engine.
+ * Instead of computing the whole spectrum, the engine multiplies both coil
+ * signals with a reference sine and cosine at the TX frequency and sums the
+ * products, which yields only the TX frequency component of each channel.
+ * In multi-tone mode the same is done for every tone in a single pass.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_IQ_DEMOD_H_
+#define SIGNALSPROCESSING_INC_IQ_DEMOD_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "app_signal.h"
+#include "metal_detecting.h"
+
+/** @brief Length of the reference tables (number of samples in one TX period). */
+#define IQ_REF_TABLE_LEN                   FP_TX_TABLE_LEN
+
+/** @brief Number of samples demodulated per block (whole TX periods only). */
+#define IQ_BLOCK_LEN                       ( ( BUFF_TO_DFT_LEN / IQ_REF_TABLE_LEN ) * IQ_REF_TABLE_LEN )
+
+/** @brief Length of the per-tone reference tables (number of samples in one multi-tone period). */
+#define IQ_TONE_TABLE_LEN                  FP_MT_TABLE_LEN
+
+/** @brief Number of tones demodulated in multi-tone mode. */
+#define IQ_TONE_COUNT                      FP_MT_TONE_COUNT
+
+/** @brief Number of samples demodulated per block in multi-tone mode (whole multi-tone periods only). */
+#define IQ_TONE_BLOCK_LEN                  ( ( BUFF_TO_DFT_LEN / IQ_TONE_TABLE_LEN ) * IQ_TONE_TABLE_LEN )
+
+
+/**
+ * @brief Handle structure for the I/Q demodulator.
+ */
+typedef struct
+{
+    float32_t ref_cos[IQ_REF_TABLE_LEN];        /*!< In-phase reference, cos(2*pi*n/L) */
+    float32_t ref_sin[IQ_REF_TABLE_LEN];        /*!< Quadrature reference, -sin(2*pi*n/L) */
+    float32_t scale;                            /*!< Scale that matches the FFT magnitude (1 / block length) */
+
+    float32_t tone_cos[IQ_TONE_COUNT][IQ_TONE_TABLE_LEN];   /*!< In-phase reference of every multi-tone tone */
+    float32_t tone_sin[IQ_TONE_COUNT][IQ_TONE_TABLE_LEN];   /*!< Quadrature reference of every multi-tone tone */
+    float32_t tone_scale;                                   /*!< Scale of the multi-tone results (1 / block length) */
+} IQ_Handle_t;
+
+/**
+ * @brief Cycle counts of the FFT and the I/Q paths measured on the same block.
+ */
+typedef struct
+{
+    uint32_t fft_cycles;                        /*!< Cycles spent in sig_load_samples(), sig_perform_fft() and sig_cross_spectrum() */
+    uint32_t iq_cycles;                         /*!< Cycles spent in iq_demodulate() */
+    uint32_t multi_cycles;                      /*!< Cycles spent in iq_demodulate_multi() */
+} IQ_Benchmark_t;
+
+
+extern IQ_Handle_t iq_handle;                   /*!< Global handle for the I/Q demodulator */
+
+extern IQ_Benchmark_t iq_benchmark_result;      /*!< Result of the last iq_benchmark() call */
+
+/**
+ * @brief Initializes the reference tables of the I/Q demodulator.
+ * @param handle Pointer to the IQ_Handle_t structure.
+ */
+void iq_init(IQ_Handle_t *const handle);
+
+/**
+ * @brief Demodulates the TX frequency component of both coil signals.
+ * @param handle Pointer to the IQ_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure holding the ADC samples.
+ * @param data Pointer to the MD_Data_t structure that receives the magnitude and the cross spectrum.
+ */
+void iq_demodulate(const IQ_Handle_t *const handle, const SIG_View_t *const view, MD_Data_t *const data);
+
+/**
+ * @brief Demodulates every tone of the multi-tone TX signal in one pass.
+ * @param handle Pointer to the IQ_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure holding the ADC samples.
+ * @param data Pointer to the MD_Data_t structure that receives the per-tone values.
+ */
+void iq_demodulate_multi(const IQ_Handle_t *const handle, const SIG_View_t *const view, MD_Data_t *const data);
+
+/**
+ * @brief Measures the cycle count of the FFT path and the I/Q path on the same block.
+ * @param handle Pointer to the IQ_Handle_t structure.
+ * @param sig Pointer to the SIG_Handle_t structure used by the FFT path.
+ * @param view Pointer to the SIG_View_t structure holding the ADC samples.
+ * @param result Pointer to the IQ_Benchmark_t structure that receives the cycle counts.
+ */
+void iq_benchmark(const IQ_Handle_t *const handle, SIG_Handle_t *const sig, const SIG_View_t *const view, IQ_Benchmark_t *const result);
+
+#endif /* SIGNALSPROCESSING_INC_IQ_DEMOD_H_ */
@@ -0,0 +1,168 @@
+/**
+ * @file iq_stream.h
+ * @brief Header file for the continuous demodulated I/Q stream.
+ *
+ * This file contains the declarations for the stream that mixes every ADC
+ * sample with the TX reference and decimates the products to one I/Q sample
+ * per IQS_DECIMATION samples. The output rate is set by SIG_IQ_STREAM_RATE_HZ
+ * and does not depend on the block length of the demodulation engines. The
+ * I/Q samples are kept in a ring that any number of consumers read at their
+ * own pace, each with its own read position. With the SIG_DEMOD_STREAM engine
+ * the detection of the signal processing task is one of these consumers.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_IQ_STREAM_H_
+#define SIGNALSPROCESSING_INC_IQ_STREAM_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "app_signal.h"
+#include "metal_detecting.h"
+
+/** @brief Number of samples in one TX period and length of the reference tables. */
+#define IQS_REF_TABLE_LEN                  FP_TX_TABLE_LEN
+
+/** @brief Fractional bits of the integer reference tables. */
+#define IQS_REF_FRAC_BITS                  14
+
+/** @brief Analysed sample rate in Hz, rounded down to an integer. */
+#define IQS_SAMPLE_RATE_HZ                 ( FP_TIMER_CLOCK_HZ / ( FP_TIM_PERIOD * FP_DECIMATION ) )
+
+/** @brief Multi-tone periods per I/Q sample, the closest count to SIG_IQ_STREAM_RATE_HZ. */
+#define IQS_PERIODS                        ( ( IQS_SAMPLE_RATE_HZ + ( SIG_IQ_STREAM_RATE_HZ * FP_MT_TABLE_LEN ) / 2 ) \
+                                             / ( SIG_IQ_STREAM_RATE_HZ * FP_MT_TABLE_LEN ) )
+
+/** @brief Number of ADC samples averaged per I/Q sample (whole multi-tone periods only). */
+#define IQS_DECIMATION                     ( IQS_PERIODS * FP_MT_TABLE_LEN )
+
+/** @brief Actual rate of the I/Q stream in Hz. */
+#define IQS_RATE_HZ                        ( FP_SAMPLE_RATE_HZ / (float)IQS_DECIMATION )
+
+/** @brief Number of I/Q samples kept for the consumers (must be a power of two). */
+#define IQS_RING_LEN                       64
+
+/** @brief Backlog in samples after which the stream drops the data and restarts. */
+#define IQS_MAX_BACKLOG                    ( INPUT_BUFF_LEN - BUFF_TO_DFT_LEN )
+
+#if IQS_PERIODS < 1
+#error "SIG_IQ_STREAM_RATE_HZ is above the rate of one I/Q sample per multi-tone period"
+#endif
+
+#if ( IQS_RING_LEN & (IQS_RING_LEN - 1) ) != 0
+#error "IQS_RING_LEN must be a power of two"
+#endif
+
+
+/**
+ * @brief Result of a read from the I/Q stream.
+ */
+typedef enum
+{
+    IQS_OK = 0,                     /*!< An I/Q sample was read */
+    IQS_EMPTY                       /*!< The reader has read all I/Q samples */
+} IQS_Status_t;
+
+
+/**
+ * @brief One sample of the I/Q stream.
+ *
+ * The components are the TX frequency components of both coils over
+ * IQS_DECIMATION samples, in the magnitude units of sig_perform_fft().
+ */
+typedef struct
+{
+    uint32_t sequence;              /*!< Number of I/Q samples produced before this one */
+    float32_t rx_real;              /*!< In-phase component of the RX coil */
+    float32_t rx_imag;              /*!< Quadrature component of the RX coil */
+    float32_t tx_real;              /*!< In-phase component of the TX coil */
+    float32_t tx_imag;              /*!< Quadrature component of the TX coil */
+    uint8_t continuous;             /*!< 0 if samples were lost between the previous I/Q sample and this one */
+} IQS_Sample_t;
+
+
+/**
+ * @brief Handle structure for the I/Q stream.
+ *
+ * The mixer and the ring are written by the signal processing task only. The
+ * ring slot of an I/Q sample is rewritten IQS_RING_LEN samples later, so a
+ * consumer that falls further behind loses the oldest samples.
+ */
+typedef struct
+{
+    int16_t ref_cos[IQS_REF_TABLE_LEN];         /*!< In-phase reference, cos(2*pi*n/L) in Q14 */
+    int16_t ref_sin[IQS_REF_TABLE_LEN];         /*!< Quadrature reference, -sin(2*pi*n/L) in Q14 */
+
+    int64_t tx_real;                            /*!< Mixed TX samples of the current I/Q sample, in-phase */
+    int64_t tx_imag;                            /*!< Mixed TX samples of the current I/Q sample, quadrature */
+    int64_t rx_real;                            /*!< Mixed RX samples of the current I/Q sample, in-phase */
+    int64_t rx_imag;                            /*!< Mixed RX samples of the current I/Q sample, quadrature */
+    uint32_t mixed;                             /*!< Number of samples mixed into the current I/Q sample */
+
+    float32_t scale;                            /*!< Scale that matches the FFT magnitude */
+    uint16_t read_index;                        /*!< Next input buffer entry to be mixed */
+    uint8_t continuous;                         /*!< Flag for the current I/Q sample, see IQS_Sample_t */
+
+    uint16_t max_backlog;                       /*!< Largest backlog seen in samples */
+    uint32_t restarts;                          /*!< Number of restarts caused by a too large backlog */
+
+    IQS_Sample_t slots[IQS_RING_LEN];           /*!< Latest I/Q samples, sample n in slots[n % IQS_RING_LEN] */
+    volatile uint32_t write_index;              /*!< Number of I/Q samples produced */
+} IQS_Handle_t;
+
+
+/**
+ * @brief Read position of one consumer of the I/Q stream.
+ */
+typedef struct
+{
+    uint32_t index;                 /*!< Sequence number of the next I/Q sample to be read */
+    uint32_t received;              /*!< Number of I/Q samples read */
+    uint32_t lost;                  /*!< Number of I/Q samples overwritten before they were read */
+} IQS_Reader_t;
+
+
+extern IQS_Handle_t iqs_handle;                 /*!< Global handle for the I/Q stream */
+
+/**
+ * @brief Initializes the I/Q stream and starts mixing at the given input buffer index.
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param write_index Current DMA write index, see sig_get_write_index().
+ */
+void iqs_init(IQS_Handle_t *const handle, uint16_t write_index);
+
+/**
+ * @brief Mixes all new samples and appends the completed I/Q samples to the ring.
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param sig Pointer to the SIG_Handle_t structure holding the ADC samples.
+ * @param write_index Current DMA write index, see sig_get_write_index().
+ * @return uint32_t Number of I/Q samples appended.
+ */
+uint32_t iqs_update(IQS_Handle_t *const handle, const SIG_Handle_t *const sig, uint16_t write_index);
+
+/**
+ * @brief Starts a reader at the newest I/Q sample.
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param reader Pointer to the IQS_Reader_t structure of the consumer.
+ */
+void iqs_reader_init(const IQS_Handle_t *const handle, IQS_Reader_t *const reader);
+
+/**
+ * @brief Reads the oldest I/Q sample the reader has not read yet.
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param reader Pointer to the IQS_Reader_t structure of the consumer.
+ * @param sample Pointer to the IQS_Sample_t structure that receives the I/Q sample.
+ * @return IQS_Status_t IQS_OK if an I/Q sample was read, IQS_EMPTY otherwise.
+ */
+IQS_Status_t iqs_read(const IQS_Handle_t *const handle, IQS_Reader_t *const reader, IQS_Sample_t *const sample);
+
+/**
+ * @brief Converts an I/Q sample to the magnitude and cross spectrum of the detector.
+ * @param sample Pointer to the IQS_Sample_t structure.
+ * @param data Pointer to the MD_Data_t structure that receives the magnitude and the cross spectrum.
+ */
+void iqs_to_data(const IQS_Sample_t *const sample, MD_Data_t *const data);
+
+#endif /* SIGNALSPROCESSING_INC_IQ_STREAM_H_ */
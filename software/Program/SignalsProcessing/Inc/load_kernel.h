@@ -0,0 +1,56 @@
+/**
+ * @file load_kernel.h
+ * @brief Header file for the fused sample conversion kernel.
+ *
+ * This file contains the declarations for the kernel that turns one block of the
+ * interleaved ADC buffer into the floating point FFT input in a single pass.
+ * Deinterleaving, DC offset removal, windowing and the conversion to float are
+ * done per sample, so the DMA buffer is read only once per block.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_LOAD_KERNEL_H_
+#define SIGNALSPROCESSING_INC_LOAD_KERNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arm_math.h"
+
+/** @brief Number of samples processed per iteration of the fast kernel. */
+#define LK_UNROLL                          4
+
+
+/**
+ * @brief Parameters of one call of the conversion kernel.
+ *
+ * The output pointers together with the stride describe both the separate
+ * buffers of the real transform (stride 1) and the interleaved buffer of the
+ * packed transform (stride 2, rx_out = tx_out + 1).
+ */
+typedef struct
+{
+    const uint32_t *src;            /*!< Interleaved ADC words, ADC1 in the low and ADC2 in the high half-word */
+    float32_t *tx_out;              /*!< Output of the TX coil samples (ADC1) */
+    float32_t *rx_out;              /*!< Output of the RX coil samples (ADC2) */
+    size_t stride;                  /*!< Distance between two consecutive output samples */
+    const float32_t *window;        /*!< Window coefficients, one per sample, or NULL for a rectangular window */
+    uint16_t dc_offset;             /*!< Offset subtracted from the ADC codes of both channels */
+    size_t len;                     /*!< Number of samples per channel */
+} LK_Params_t;
+
+
+/**
+ * @brief Portable reference implementation of the conversion kernel.
+ * @param params Pointer to the LK_Params_t structure describing the conversion.
+ */
+void lk_convert_ref(const LK_Params_t *const params);
+
+/**
+ * @brief Converts the samples with the fastest implementation available for the target.
+ * @param params Pointer to the LK_Params_t structure describing the conversion.
+ */
+void lk_convert(const LK_Params_t *const params);
+
+#endif /* SIGNALSPROCESSING_INC_LOAD_KERNEL_H_ */
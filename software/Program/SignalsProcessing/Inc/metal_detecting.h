@@ -25,16 +25,93 @@ typedef enum
     NO_TARGET            				/*!< Indicates that no target has been detected */
 } MD_DetectStatus_t;
 
+/**
+ * @brief Sign convention of the phase difference reported by md_detect().
+ */
+typedef enum
+{
+    MD_PHASE_UNSIGNED = 0,              /*!< Absolute phase difference in the range 0..180 degrees */
+    MD_PHASE_SIGNED                     /*!< TX phase minus RX phase in the range -180..180 degrees */
+} MD_PhaseMode_t;
+
+/**
+ * @brief Detector selected with md_set_detector().
+ */
+typedef enum
+{
+    MD_DETECTOR_STATIC = 0,             /*!< Magnitude step from the previous frame above the ground balance */
+    MD_DETECTOR_MOTION                  /*!< Deviation from the tracked background vector, with hysteresis */
+} MD_Detector_t;
+
+/** @brief Maximum number of TX tones demodulated at the same time. */
+#define MD_MAX_TONES                    3
+
+/** @brief Detector selected by md_init(). */
+#ifndef MD_DEFAULT_DETECTOR
+#define MD_DEFAULT_DETECTOR             MD_DETECTOR_STATIC
+#endif
+
+/** @brief Default cutoff frequency of the background high-pass of the motion detector in Hz. */
+#define MD_MOTION_CUTOFF_HZ             1.0f
+
+/** @brief Fraction of the sensitivity below which a motion detection is released. */
+#define MD_MOTION_RELEASE_RATIO         0.5f
+
+/** @brief Factor slowing down the background tracking while a target is detected. */
+#define MD_MOTION_HOLD_FACTOR           0.1f
+
+/**
+ * @brief Structure to hold the signal data of one TX tone.
+ */
+typedef struct
+{
+    float32_t rx_signal_magnitude; 		/*!< Magnitude of the received tone */
+    float32_t tx_signal_magnitude; 		/*!< Magnitude of the transmitted tone */
+    float32_t cross_real;    			/*!< Real part of the cross spectrum RX * conj(TX) of the tone */
+    float32_t cross_imag;    			/*!< Imaginary part of the cross spectrum RX * conj(TX) of the tone */
+} MD_ToneData_t;
+
 /**
  * @brief Structure to hold signal data for metal detection.
+ *
+ * The scalar fields always describe the primary TX tone. In multi-tone mode
+ * tones[] additionally holds every tone, tones[0] being the primary one.
+ * The phase of the received signal relative to the transmitted one is the
+ * angle of the cross spectrum RX * conj(TX), in units of the squared
+ * magnitude. The cross spectrum is linear in both signals, so it can be
+ * averaged over frames before its angle is taken. After gb_update() the RX
+ * magnitudes exclude the ground component, while the cross spectrum still
+ * holds it, so the phase is that of the whole response.
  */
 typedef struct
 {
-    float32_t tx_signal_phase;    		/*!< Phase of the transmitted signal in radians */
     float32_t rx_signal_magnitude; 		/*!< Magnitude of the received signal */
-    float32_t rx_signal_phase;    		/*!< Phase of the received signal in radians */
+    float32_t tx_signal_magnitude; 		/*!< Magnitude of the transmitted signal */
+    float32_t cross_real;    			/*!< Real part of the cross spectrum RX * conj(TX) */
+    float32_t cross_imag;    			/*!< Imaginary part of the cross spectrum RX * conj(TX) */
+    MD_ToneData_t tones[MD_MAX_TONES];	/*!< Per-tone data in multi-tone mode */
+    uint8_t tone_count;					/*!< Number of valid entries in tones[], 0 in single-tone mode */
+    float32_t ground_real;				/*!< Real part of the unit vector of the ground direction, 0 without a ground balance */
+    float32_t ground_imag;				/*!< Imaginary part of the unit vector of the ground direction, 0 without a ground balance */
 } MD_Data_t;
 
+/**
+ * @brief State of the motion detector.
+ *
+ * The background is the RX vector referenced to the TX phase, in units of the
+ * RX magnitude, low-pass filtered over the frames. Its difference from the
+ * current vector is the high-pass filtered signal of a moving target.
+ */
+typedef struct
+{
+    float32_t background_real;			/*!< Real part of the tracked background vector */
+    float32_t background_imag;			/*!< Imaginary part of the tracked background vector */
+    float32_t alpha;					/*!< Weight of a new frame in the background */
+    float32_t update_period_ms;			/*!< Time between two frames in milliseconds */
+    uint8_t primed;						/*!< 0 until the first frame initialized the background */
+    uint8_t active;						/*!< 1 while a target is detected */
+} MD_Motion_t;
+
 /**
  * @brief Structure to hold detection parameters and state.
  */
@@ -43,17 +120,32 @@ typedef struct
     float32_t last_magnitude; 			/*!< Last recorded signal magnitude */
     float32_t gnd_balance;    			/*!< Ground balance parameter for detection */
     float32_t sensitivity;    			/*!< Sensitivity parameter for detection */
+    MD_PhaseMode_t phase_mode;			/*!< Sign convention of the reported phase difference */
+    MD_Detector_t detector;				/*!< Detector used by md_detect() */
+    MD_Motion_t motion;					/*!< State of the motion detector */
+    float32_t target_magnitude;			/*!< Magnitude of the last detected target above the background */
 } MD_Handle_t;
 
 /** @brief Global handle for metal detecting operations. */
 extern MD_Handle_t md_handle;
 
+/**
+ * @brief Selects the default detector and sets the frame period of the motion detector.
+ *
+ * The ground balance, the sensitivity and the phase mode are kept.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param update_period_ms Time between two calls of md_detect() in milliseconds.
+ */
+void md_init(MD_Handle_t *const handle, float32_t update_period_ms);
+
 /**
  * @brief Detects the presence of a target based on signal data.
  *
- * This function evaluates whether a target is detected by comparing the received signal
- * magnitude with ground balance and sensitivity thresholds. It calculates the phase
- * difference between the transmitted and received signals.
+ * This function evaluates whether a target is detected with the detector
+ * selected by md_set_detector(). It calculates the phase difference between
+ * the transmitted and received signals from the cross spectrum, and stores
+ * the magnitude of a detected target in target_magnitude.
  *
  * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
  * @param data Pointer to the MD_Data_t structure containing the received signal data.
@@ -62,6 +154,19 @@ extern MD_Handle_t md_handle;
  */
 MD_DetectStatus_t md_detect(MD_Handle_t *const handle, const MD_Data_t *const data, int16_t *const phase_difference);
 
+/**
+ * @brief Returns the phase difference between the transmitted and received signals.
+ *
+ * Only one arctangent of the cross spectrum is taken, so the result is free of
+ * the wrap-around of a difference of two phases.
+ *
+ * @param cross_real Real part of the cross spectrum RX * conj(TX).
+ * @param cross_imag Imaginary part of the cross spectrum RX * conj(TX).
+ * @param mode Sign convention of the result.
+ * @return float32_t Phase difference in degrees.
+ */
+float32_t md_phase_difference(float32_t cross_real, float32_t cross_imag, MD_PhaseMode_t mode);
+
 /**
  * @brief Sets the ground balance parameter for metal detection.
  *
@@ -82,4 +187,28 @@ void md_set_gndbalance(MD_Handle_t *const handle, uint16_t new_balance);
  */
 void md_set_sensitivity(MD_Handle_t *const handle, uint16_t new_sens);
 
+/**
+ * @brief Selects the sign convention of the phase difference reported by md_detect().
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param mode MD_PHASE_UNSIGNED (default) or MD_PHASE_SIGNED.
+ */
+void md_set_phase_mode(MD_Handle_t *const handle, MD_PhaseMode_t mode);
+
+/**
+ * @brief Selects the detector used by md_detect() and restarts the motion detector.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param detector MD_DETECTOR_STATIC or MD_DETECTOR_MOTION.
+ */
+void md_set_detector(MD_Handle_t *const handle, MD_Detector_t detector);
+
+/**
+ * @brief Sets the cutoff frequency of the background high-pass of the motion detector.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param cutoff_hz Cutoff frequency in Hz, a lower one also detects slower sweeps.
+ */
+void md_set_motion_cutoff(MD_Handle_t *const handle, float32_t cutoff_hz);
+
 #endif /* SIGNALSPROCESSING_INC_METAL_DETECTING_H_ */
@@ -0,0 +1,31 @@
+/**
+ * @file packed_fft.h
+ * @brief Header file for the split of a packed complex FFT into the spectra of two real signals.
+ *
+ * This file contains the declaration of the step that follows the complex FFT
+ * of the packed transform, z[n] = tx[n] + j * rx[n]. It takes the spectra of
+ * both real signals out of the spectrum of z and writes them in the layout of
+ * arm_rfft_fast_f32(). It has no dependencies on the hardware, so the host
+ * tests can check it against a direct DFT.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_PACKED_FFT_H_
+#define SIGNALSPROCESSING_INC_PACKED_FFT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arm_math.h"
+
+/**
+ * @brief Splits the spectrum of z[n] = tx[n] + j * rx[n] into the spectra of tx and rx.
+ * @param packed Spectrum of z, len interleaved complex values as produced by arm_cfft_f32().
+ * @param len Transform length, even.
+ * @param tx Spectrum of tx, len / 2 interleaved complex values in the layout of arm_rfft_fast_f32().
+ * @param rx Spectrum of rx, in the same layout as tx.
+ */
+void pfft_split(const float32_t *packed, size_t len, float32_t *tx, float32_t *rx);
+
+#endif /* SIGNALSPROCESSING_INC_PACKED_FFT_H_ */
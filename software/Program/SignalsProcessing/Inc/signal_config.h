@@ -0,0 +1,105 @@
+/**
+ * @file signal_config.h
+ * @brief Compile-time configuration of the signal processing chain.
+ *
+ * This file collects the build options that select between the available
+ * signal processing paths. It has no dependencies, so it can be included by
+ * every module of the signal chain. Every option can also be overridden from
+ * the compiler command line.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_SIGNAL_CONFIG_H_
+#define SIGNALSPROCESSING_INC_SIGNAL_CONFIG_H_
+
+/** @brief Demodulation engine computing the full spectrum with the FFT. */
+#define SIG_DEMOD_FFT                      0
+
+/** @brief Demodulation engine computing only the TX frequency component (see iq_demod.h). */
+#define SIG_DEMOD_IQ                       1
+
+/** @brief Demodulation engine updating the TX frequency component with a sliding DFT (see sliding_dft.h). */
+#define SIG_DEMOD_SDFT                     2
+
+/** @brief Demodulation engine detecting on the fixed-rate I/Q stream instead of the blocks (see iq_stream.h). */
+#define SIG_DEMOD_STREAM                   3
+
+/** @brief Demodulation engine used by the signal processing task. */
+#ifndef SIG_DEMOD_ENGINE
+#define SIG_DEMOD_ENGINE                   SIG_DEMOD_IQ
+#endif
+
+/** @brief FFT path working on 32-bit floating point samples. */
+#define SIG_ARITHMETIC_F32                 0
+
+/** @brief FFT path working on Q15 fixed point samples. */
+#define SIG_ARITHMETIC_Q15                 1
+
+/**
+ * @brief Number format of the FFT path (sample buffers, spectra and polar form).
+ *
+ * The fixed point build is Q15 only, there is no Q31 path: the 12-bit samples
+ * (14-bit after oversampling or decimation) fit Q15 with headroom, and Q31
+ * would double the buffer memory that Q15 is meant to save. The Q15 chain runs
+ * in integer arithmetic up to sig_cross_spectrum(), MD_Data_t and the detector
+ * stages stay floating point in both builds.
+ */
+#ifndef SIG_ARITHMETIC
+#define SIG_ARITHMETIC                     SIG_ARITHMETIC_F32
+#endif
+
+/** @brief Acquisition front-end storing every 12-bit ADC conversion. */
+#define SIG_FRONTEND_DIRECT                0
+
+/** @brief Acquisition front-end averaging SIG_OVERSAMPLING_RATIO conversions per sample in the ADC oversampler. */
+#define SIG_FRONTEND_OVERSAMPLE            1
+
+/** @brief Acquisition front-end sampling SIG_DECIMATION times faster and decimating in software (see decimator.h). */
+#define SIG_FRONTEND_DECIMATE              2
+
+/** @brief Acquisition front-end delivering the samples to the signal chain. */
+#ifndef SIG_FRONTEND
+#define SIG_FRONTEND                       SIG_FRONTEND_DIRECT
+#endif
+
+/** @brief Number of conversions summed by the ADC oversampler per sample (SIG_FRONTEND_OVERSAMPLE). */
+#define SIG_OVERSAMPLING_RATIO             16
+
+/** @brief Ratio of the raw ADC rate to the analysis rate (SIG_FRONTEND_DECIMATE), 2, 4 or 8. */
+#ifndef SIG_DECIMATION
+#define SIG_DECIMATION                     4
+#endif
+
+/** @brief Requested rate of the demodulated I/Q stream in Hz (see iq_stream.h). */
+#ifndef SIG_IQ_STREAM_RATE_HZ
+#define SIG_IQ_STREAM_RATE_HZ              1000
+#endif
+
+/**
+ * @brief Number of blocks in the ADC capture ring (see capture.h), at least 2.
+ *
+ * The DMA holds the block it writes and the next one, so a block waiting in
+ * the frame ring stays intact while the frame ring depth stays below the
+ * count minus 2. 8 blocks allow a backlog of 6 blocks, about 41 ms of the
+ * signal processing task being held up.
+ *
+ * Open item: the count of 8 has not been measured yet. The diagnostics tab
+ * shows the largest frame ring depth, the dropped frames and the blocks
+ * overwritten since start-up. To measure it, run the FFT engine with the
+ * frequency domain chart open, switch the tabs and the chart domain for a
+ * few minutes, and read these values. The count should be the largest depth
+ * plus 2, plus a margin of at least one block, with no drops and no
+ * overwritten blocks.
+ */
+#ifndef SIG_CAPTURE_BLOCK_COUNT
+#define SIG_CAPTURE_BLOCK_COUNT            8
+#endif
+
+/** @brief Set to 1 to measure the cycle count of both demodulation engines on every block. */
+#ifndef SIG_BENCHMARK_ENABLE
+#define SIG_BENCHMARK_ENABLE               0
+#endif
+
+#endif /* SIGNALSPROCESSING_INC_SIGNAL_CONFIG_H_ */
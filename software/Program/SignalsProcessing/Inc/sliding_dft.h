@@ -0,0 +1,117 @@
+/**
+ * @file sliding_dft.h
+ * @brief Header file for the sliding DFT streaming demodulator.
+ *
+ * This file contains the declarations for the streaming demodulation engine.
+ * The engine reads the ADC buffer in small sub-blocks while the DMA is still
+ * filling it, and updates the TX frequency component of a window of the last
+ * SDFT_WINDOW_LEN samples after every sub-block. A new MD_Data_t is therefore
+ * available every SDFT_SUBBLOCK_LEN samples instead of once per block.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_SLIDING_DFT_H_
+#define SIGNALSPROCESSING_INC_SLIDING_DFT_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "app_signal.h"
+#include "metal_detecting.h"
+
+/** @brief Number of samples in one TX period and length of the reference tables. */
+#define SDFT_REF_TABLE_LEN                 FP_TX_TABLE_LEN
+
+/** @brief Number of samples consumed per update (must divide INPUT_BUFF_LEN). */
+#define SDFT_SUBBLOCK_LEN                  32
+
+/** @brief Number of samples in the sliding window (whole TX periods only). */
+#define SDFT_WINDOW_LEN                    ( 32 * SDFT_REF_TABLE_LEN )
+
+/** @brief Fractional bits of the integer reference tables. */
+#define SDFT_REF_FRAC_BITS                 14
+
+/** @brief Backlog in samples after which the engine drops the data and restarts. */
+#define SDFT_MAX_BACKLOG                   ( INPUT_BUFF_LEN - BUFF_TO_DFT_LEN )
+
+/** @brief Longest wait in milliseconds for a wake-up, after which the signal processing task reads the DMA position anyway. */
+#define SDFT_POLL_PERIOD_MS                1
+
+/** @brief Thread flag set on the signal processing task when new sub-blocks were written. */
+#define SDFT_THREAD_FLAG                   0x0002U
+
+#if SIG_FRONTEND == SIG_FRONTEND_DECIMATE
+/** @brief Number of samples between two wake-ups of the signal processing task, one decimator chunk. */
+#define SDFT_WAKE_LEN                      SIG_DEC_CHUNK_LEN
+#else
+/** @brief Number of samples between two wake-ups of the signal processing task, one sub-block. */
+#define SDFT_WAKE_LEN                      SDFT_SUBBLOCK_LEN
+#endif
+
+
+/**
+ * @brief Result of one sdft_update() call.
+ */
+typedef enum
+{
+    SDFT_IDLE = 0,                  /*!< No complete sub-block is available yet */
+    SDFT_FILLING,                   /*!< A sub-block was consumed, but the window is not full yet */
+    SDFT_RESULT                     /*!< A sub-block was consumed and a new result was emitted */
+} SDFT_Status_t;
+
+
+/**
+ * @brief Handle structure for the sliding DFT.
+ *
+ * The correlation sums are updated with integer arithmetic only, and the
+ * sample leaving the window is taken from the engine's own history, so the
+ * sums always equal the direct correlation of the window exactly and cannot
+ * drift, no matter how long the engine runs.
+ */
+typedef struct
+{
+    int16_t ref_cos[SDFT_REF_TABLE_LEN];        /*!< In-phase reference, cos(2*pi*n/L) in Q14 */
+    int16_t ref_sin[SDFT_REF_TABLE_LEN];        /*!< Quadrature reference, -sin(2*pi*n/L) in Q14 */
+
+    int16_t tx_history[SDFT_WINDOW_LEN];        /*!< DC-free TX samples of the current window */
+    int16_t rx_history[SDFT_WINDOW_LEN];        /*!< DC-free RX samples of the current window */
+
+    int64_t tx_real;                            /*!< Correlation of the TX window with the in-phase reference */
+    int64_t tx_imag;                            /*!< Correlation of the TX window with the quadrature reference */
+    int64_t rx_real;                            /*!< Correlation of the RX window with the in-phase reference */
+    int64_t rx_imag;                            /*!< Correlation of the RX window with the quadrature reference */
+
+    float32_t scale;                            /*!< Scale that matches the FFT magnitude (1 / (window * Q14)) */
+
+    uint16_t read_index;                        /*!< Next input buffer entry to be consumed */
+    uint16_t history_index;                     /*!< Oldest history entry, replaced by the next sample */
+    uint16_t filled;                            /*!< Number of valid samples in the window */
+
+    uint16_t backlog;                           /*!< Samples waiting in the input buffer at the last poll */
+    uint16_t max_backlog;                       /*!< Largest backlog seen, the worst case latency in samples */
+    uint32_t overruns;                          /*!< Number of restarts caused by a too large backlog */
+    uint32_t updates;                           /*!< Number of emitted results */
+} SDFT_Handle_t;
+
+
+extern SDFT_Handle_t sdft_handle;               /*!< Global handle for the sliding DFT */
+
+/**
+ * @brief Initializes the sliding DFT and starts reading at the given input buffer index.
+ * @param handle Pointer to the SDFT_Handle_t structure.
+ * @param write_index Current DMA write index, see sig_get_write_index().
+ */
+void sdft_init(SDFT_Handle_t *const handle, uint16_t write_index);
+
+/**
+ * @brief Consumes one sub-block of new samples and updates the TX frequency component.
+ * @param handle Pointer to the SDFT_Handle_t structure.
+ * @param sig Pointer to the SIG_Handle_t structure holding the ADC samples.
+ * @param write_index Current DMA write index, see sig_get_write_index().
+ * @param data Pointer to the MD_Data_t structure that receives the magnitude and the cross spectrum.
+ * @return SDFT_Status_t SDFT_RESULT if data holds a new result.
+ */
+SDFT_Status_t sdft_update(SDFT_Handle_t *const handle, const SIG_Handle_t *const sig, uint16_t write_index, MD_Data_t *const data);
+
+#endif /* SIGNALSPROCESSING_INC_SLIDING_DFT_H_ */
@@ -0,0 +1,117 @@
+/**
+ * @file sync_average.h
+ * @brief Header file for the synchronous averaging of the demodulated TX tone.
+ *
+ * This file contains the declarations for the stage that averages the complex
+ * TX frequency components of consecutive results before their magnitude and
+ * phase are taken. The cross spectrum RX * conj(TX) is referenced to the TX
+ * phase, so it adds up coherently from one result to the next while the noise
+ * does not. The average is exponential with a settable time constant, and an
+ * optional second average with a shorter attack time lets a rising signal
+ * through quickly, as soon as it stands out of the noise. A third average
+ * with its own decay time does the same for a falling signal, so a target
+ * that leaves is not held for the whole time constant.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_SYNC_AVERAGE_H_
+#define SIGNALSPROCESSING_INC_SYNC_AVERAGE_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "metal_detecting.h"
+
+/** @brief Default time constant of the average in milliseconds. */
+#define SA_TIME_CONSTANT_MS                50.0f
+
+/** @brief Default attack time in milliseconds, 0 disables the fast attack. */
+#define SA_ATTACK_TIME_MS                  5.0f
+
+/** @brief Default decay time in milliseconds, shorter than the time constant, 0 disables the fast decay. */
+#define SA_DECAY_TIME_MS                   10.0f
+
+/** @brief Rise of the attack average above the slow one, in noise standard deviations, that takes over the slow one. */
+#define SA_ATTACK_THRESHOLD                4.0f
+
+
+/**
+ * @brief Averaged values of one tone.
+ */
+typedef struct
+{
+    float32_t cross_real;                       /*!< Average of the real part of RX * conj(TX) */
+    float32_t cross_imag;                       /*!< Average of the imaginary part of RX * conj(TX) */
+    float32_t attack_real;                      /*!< Average of the real part of RX * conj(TX) with the attack time */
+    float32_t attack_imag;                      /*!< Average of the imaginary part of RX * conj(TX) with the attack time */
+    float32_t decay_real;                       /*!< Average of the real part of RX * conj(TX) with the decay time */
+    float32_t decay_imag;                       /*!< Average of the imaginary part of RX * conj(TX) with the decay time */
+    float32_t noise_power;                      /*!< Average power of the deviation of a result from the average */
+    float32_t tx_magnitude;                     /*!< Average of the TX magnitude */
+} SA_Channel_t;
+
+
+/**
+ * @brief Handle structure for the synchronous averager.
+ *
+ * channel[0] averages the primary tone and channel[t + 1] tone t of the
+ * multi-tone mode, tone 0 being the primary tone again.
+ */
+typedef struct
+{
+    SA_Channel_t channel[MD_MAX_TONES + 1];     /*!< Averages of the primary tone and of every tone */
+    float32_t update_period_ms;                 /*!< Time between two results in milliseconds */
+    float32_t release_alpha;                    /*!< Weight of a new result, 1 when averaging is disabled */
+    float32_t attack_alpha;                     /*!< Weight of a new result in the attack average */
+    float32_t attack_limit;                     /*!< Squared deviation of the attack average that counts as a rise, relative to noise_power */
+    float32_t decay_alpha;                      /*!< Weight of a new result in the decay average */
+    float32_t decay_limit;                      /*!< Squared deviation of the decay average that counts as a fall, relative to noise_power */
+    uint8_t primed;                             /*!< 0 until the first result initialized the averages */
+} SA_Handle_t;
+
+
+extern SA_Handle_t sa_handle;                   /*!< Global handle for the synchronous averager */
+
+/**
+ * @brief Initializes the averager with the default time constants.
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param update_period_ms Time between two results in milliseconds.
+ */
+void sa_init(SA_Handle_t *const handle, float32_t update_period_ms);
+
+/**
+ * @brief Sets the time constant of the average.
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param time_constant_ms Time constant in milliseconds, 0 disables the averaging.
+ */
+void sa_set_time_constant(SA_Handle_t *const handle, float32_t time_constant_ms);
+
+/**
+ * @brief Sets the attack time used while the signal rises above the average.
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param attack_time_ms Attack time in milliseconds, 0 disables the fast attack.
+ */
+void sa_set_attack_time(SA_Handle_t *const handle, float32_t attack_time_ms);
+
+/**
+ * @brief Sets the decay time used while the signal falls below the average.
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param decay_time_ms Decay time in milliseconds, 0 disables the fast decay.
+ */
+void sa_set_decay_time(SA_Handle_t *const handle, float32_t decay_time_ms);
+
+/**
+ * @brief Restarts the averages from the next result.
+ * @param handle Pointer to the SA_Handle_t structure.
+ */
+void sa_reset(SA_Handle_t *const handle);
+
+/**
+ * @brief Averages a new result and replaces its magnitude and cross spectrum by the averages.
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param data Pointer to the MD_Data_t structure of the new result, overwritten with the averaged values.
+ */
+void sa_update(SA_Handle_t *const handle, MD_Data_t *const data);
+
+#endif /* SIGNALSPROCESSING_INC_SYNC_AVERAGE_H_ */
@@ -0,0 +1,113 @@
+/**
+ * @file target_event.h
+ * @brief Header file for the target event detector.
+ *
+ * This file contains the declarations for the state machine that turns the
+ * per-frame detections of md_detect() into one event per pass of the coil
+ * over a target. An event starts with the first detected frame, collects the
+ * peak magnitude and the magnitude-weighted phase while the target is
+ * detected, and ends once no frame detected it for TE_RELEASE_MS.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_TARGET_EVENT_H_
+#define SIGNALSPROCESSING_INC_TARGET_EVENT_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "metal_detecting.h"
+
+/** @brief Time without a detected frame after which an event ends, in milliseconds. */
+#define TE_RELEASE_MS                      40.0f
+
+/** @brief Longest event in milliseconds, a target that stays longer gives one event per this time. */
+#define TE_MAX_DURATION_MS                 2000.0f
+
+/** @brief Detected time from which the duration no longer lowers the confidence, in milliseconds. */
+#define TE_FULL_CONFIDENCE_MS              60.0f
+
+/** @brief Standard deviation of the phase in degrees at which the confidence drops to zero. */
+#define TE_PHASE_SPREAD_LIMIT              45.0f
+
+
+/**
+ * @brief Result of one update of the event detector.
+ */
+typedef enum
+{
+    TE_NO_EVENT = 0,                /*!< No event ended with this frame */
+    TE_EVENT                        /*!< An event ended, the event structure holds it */
+} TE_Status_t;
+
+
+/**
+ * @brief State of the event detector.
+ */
+typedef enum
+{
+    TE_IDLE = 0,                    /*!< No target is detected */
+    TE_ACTIVE                       /*!< A target is detected or was detected less than TE_RELEASE_MS ago */
+} TE_State_t;
+
+
+/**
+ * @brief One pass of the coil over a target.
+ */
+typedef struct
+{
+    float32_t peak_magnitude;       /*!< Largest magnitude of the pass */
+    int16_t phase;                  /*!< Magnitude-weighted mean phase difference in degrees */
+    uint16_t duration_ms;           /*!< Time from the first to the last detected frame in milliseconds */
+    uint16_t frames;                /*!< Number of detected frames */
+    uint8_t confidence;             /*!< Confidence in percent, from the detected time and the phase spread */
+} TE_Event_t;
+
+
+/**
+ * @brief Handle structure for the event detector.
+ *
+ * The phase is accumulated relative to the phase of the first frame, so the
+ * mean does not jump where the phase wraps around at 180 degrees.
+ */
+typedef struct
+{
+    TE_State_t state;                           /*!< Current state */
+    float32_t update_period_ms;                 /*!< Time between two frames in milliseconds */
+    uint32_t release_frames;                    /*!< Frames without detection that end an event */
+    uint32_t max_frames;                        /*!< Frames after which a long event is ended */
+
+    uint32_t elapsed;                           /*!< Frames since the first detected frame */
+    uint32_t last_detected;                     /*!< Value of elapsed at the last detected frame */
+    uint32_t detected;                          /*!< Number of detected frames */
+    int16_t onset_phase;                        /*!< Phase of the first detected frame */
+    float32_t peak_magnitude;                   /*!< Largest magnitude so far */
+    float32_t weight_sum;                       /*!< Sum of the magnitudes */
+    float32_t phase_sum;                        /*!< Sum of the magnitude-weighted phase offsets */
+    float32_t phase_square_sum;                 /*!< Sum of the magnitude-weighted squared phase offsets */
+} TE_Handle_t;
+
+
+extern TE_Handle_t te_handle;                   /*!< Global handle for the event detector */
+
+/**
+ * @brief Initializes the event detector in the idle state.
+ * @param handle Pointer to the TE_Handle_t structure.
+ * @param update_period_ms Time between two frames in milliseconds.
+ */
+void te_init(TE_Handle_t *const handle, float32_t update_period_ms);
+
+/**
+ * @brief Advances the event detector by one frame.
+ * @param handle Pointer to the TE_Handle_t structure.
+ * @param status Detection status of the frame.
+ * @param magnitude Magnitude of the target in the frame, used if it was detected.
+ * @param phase_difference Phase difference of the target in the frame in degrees, used if it was detected.
+ * @param event Pointer to the TE_Event_t structure that receives an ended event.
+ * @return TE_Status_t TE_EVENT if an event ended with this frame, TE_NO_EVENT otherwise.
+ */
+TE_Status_t te_update(TE_Handle_t *const handle, MD_DetectStatus_t status, float32_t magnitude,
+                      int16_t phase_difference, TE_Event_t *const event);
+
+#endif /* SIGNALSPROCESSING_INC_TARGET_EVENT_H_ */
@@ -0,0 +1,98 @@
+/**
+ * @file target_tracker.h
+ * @brief Header file for the target tracker.
+ *
+ * This file contains the declarations for the alpha-beta tracker that smooths
+ * the complex target response reported by md_detect() over the frames of a
+ * pass, so the phase and the magnitude shown to the user do not jitter from
+ * frame to frame. Its gains follow the measured motion of the response, and
+ * are never lower than what keeps the added latency below TT_MAX_LATENCY_MS.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_TARGET_TRACKER_H_
+#define SIGNALSPROCESSING_INC_TARGET_TRACKER_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "metal_detecting.h"
+
+/** @brief Worst-case time for the output to settle to TT_SETTLE_RATIO of a step of the response, in milliseconds. */
+#define TT_MAX_LATENCY_MS                  50.0f
+
+/** @brief Fraction of a step that the output reaches within TT_MAX_LATENCY_MS. */
+#define TT_SETTLE_RATIO                    0.9f
+
+/** @brief Largest position gain, used at the start of a track and for fast motion. */
+#define TT_MAX_ALPHA                       0.9f
+
+/** @brief Time without a detected frame after which the track is dropped, in milliseconds. */
+#define TT_COAST_MS                        40.0f
+
+/** @brief Weight of a new frame in the measurement noise estimate. */
+#define TT_NOISE_WEIGHT                    0.05f
+
+/** @brief Weight of a new frame in the innovation power. */
+#define TT_INNOVATION_WEIGHT               0.05f
+
+/** @brief Factor on the innovation power of the noise alone below which the response counts as standing still. */
+#define TT_MOTION_MARGIN                   2.0f
+
+
+/**
+ * @brief Handle structure for the target tracker.
+ *
+ * The state is the target response as a vector of the magnitude at the
+ * phase angle, and its change per frame. The velocity gain beta follows from
+ * the position gain alpha as in a steady-state Kalman filter.
+ */
+typedef struct
+{
+    float32_t update_period_ms;                 /*!< Time between two frames in milliseconds */
+    float32_t min_alpha;                        /*!< Lowest position gain, given by TT_MAX_LATENCY_MS */
+    uint32_t coast_frames;                      /*!< Frames without detection that drop the track */
+
+    uint8_t tracking;                           /*!< 1 while a track is held */
+    uint8_t history;                            /*!< Number of consecutive measurements held, up to 2 */
+    uint32_t frames;                            /*!< Detected frames since the start of the track */
+    uint32_t missed;                            /*!< Frames without detection since the last detected one */
+    float32_t real;                             /*!< Real part of the tracked response */
+    float32_t imag;                             /*!< Imaginary part of the tracked response */
+    float32_t velocity_real;                    /*!< Change of the real part per frame */
+    float32_t velocity_imag;                    /*!< Change of the imaginary part per frame */
+    float32_t last_real[2];                     /*!< Real parts of the last two measurements, the newest first */
+    float32_t last_imag[2];                     /*!< Imaginary parts of the last two measurements, the newest first */
+
+    float32_t alpha;                            /*!< Current position gain */
+    float32_t beta;                             /*!< Current velocity gain */
+    float32_t noise_power;                      /*!< Estimated measurement noise variance per component */
+    float32_t innovation_power;                 /*!< Averaged power of the prediction error, both components */
+
+    float32_t magnitude;                        /*!< Smoothed magnitude, valid while tracking */
+    float32_t phase;                            /*!< Smoothed phase difference in degrees, valid while tracking */
+} TT_Handle_t;
+
+
+extern TT_Handle_t tt_handle;                   /*!< Global handle for the target tracker */
+
+/**
+ * @brief Initializes the tracker without a track and derives the gain limits from the frame period.
+ * @param handle Pointer to the TT_Handle_t structure.
+ * @param update_period_ms Time between two frames in milliseconds.
+ */
+void tt_init(TT_Handle_t *const handle, float32_t update_period_ms);
+
+/**
+ * @brief Advances the tracker by one frame.
+ * @param handle Pointer to the TT_Handle_t structure.
+ * @param status Detection status of the frame.
+ * @param magnitude Pointer to the magnitude of the target in the frame, replaced by the smoothed one if it was detected.
+ * @param phase_difference Pointer to the phase difference in degrees, replaced by the smoothed one if it was detected.
+ * @return uint8_t 1 if the smoothed magnitude and phase are valid, 0 if no track is held.
+ */
+uint8_t tt_update(TT_Handle_t *const handle, MD_DetectStatus_t status, float32_t *const magnitude,
+                  int16_t *const phase_difference);
+
+#endif /* SIGNALSPROCESSING_INC_TARGET_TRACKER_H_ */
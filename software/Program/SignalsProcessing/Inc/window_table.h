@@ -0,0 +1,55 @@
+/**
+ * @file window_table.h
+ * @brief Header file for the window function tables.
+ *
+ * This file contains the declarations for the precomputed window functions.
+ * Every window is stored once for each supported FFT length in DTCM, so the
+ * sample loading stage only has to look up the table of the current length.
+ * The coefficients are divided by the coherent gain of the window, so the
+ * magnitude of a tone is the same with every window.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef SIGNALSPROCESSING_INC_WINDOW_TABLE_H_
+#define SIGNALSPROCESSING_INC_WINDOW_TABLE_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "fft_plan.h"
+
+/** @brief Places a variable in the DTCM, which is accessed by the core without wait states. */
+#define WIN_DTCM                           __attribute__((section(".dtcm")))
+
+/** @brief Number of coefficients of one window for all supported lengths (FFT_PLAN_MIN_LEN + ... + FFT_PLAN_MAX_LEN). */
+#define WIN_TABLE_LEN                      ( 2 * FFT_PLAN_MAX_LEN - FFT_PLAN_MIN_LEN )
+
+
+/**
+ * @brief Window functions available for the FFT.
+ */
+typedef enum
+{
+    WIN_RECTANGULAR = 0,            /*!< No window */
+    WIN_HANN,                       /*!< Hann window, good general purpose choice */
+    WIN_BLACKMAN_HARRIS,            /*!< 4-term Blackman-Harris window, lowest leakage */
+    WIN_FLAT_TOP,                   /*!< Flat-top window, most accurate magnitude between bins */
+    WIN_COUNT                       /*!< Number of window functions */
+} WIN_Type_t;
+
+
+/**
+ * @brief Computes the window tables for all window functions and supported lengths.
+ */
+void win_init(void);
+
+/**
+ * @brief Returns the coefficients of a window for the given FFT length.
+ * @param type Window function.
+ * @param len FFT length, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const float32_t* Coefficients, or NULL for the rectangular window or an unsupported length.
+ */
+const float32_t *win_get(WIN_Type_t type, uint16_t len);
+
+#endif /* SIGNALSPROCESSING_INC_WINDOW_TABLE_H_ */
@@ -14,6 +14,7 @@
  */
 
 
+#include <string.h>
 #include "adc.h"
 #include "dac.h"
 #include "tim.h"
@@ -21,47 +22,139 @@
 #include "ui.h"
 #include "app_tasks.h"
 #include "app_signal.h"
+#include "cycle_counter.h"
+#include "capture.h"
+#include "load_kernel.h"
+#include "packed_fft.h"
+#include "fast_math.h"
+#include "decimator.h"
+#include "sliding_dft.h"
 
 
-const uint32_t OUTPUT_SINE_SIGNAL[OUTPUT_SINE_SIGNAL_LEN] = {2048, 3251, 3995, 3996, 3253, 2051, 847, 101, 98, 839};
+#if ( SIG_FRONTEND < SIG_FRONTEND_DIRECT ) || ( SIG_FRONTEND > SIG_FRONTEND_DECIMATE )
+#error "SIG_FRONTEND out of range"
+#endif
 
-const uint32_t OUTPUT_AUDIO_SIGNAL[OUTPUT_SINE_AUDIO_LEN] = {
-		2048, 2176, 2304,
-		2431, 2557, 2680, 2801, 2919, 3034, 3145, 3251, 3353, 3449, 3540, 3625,
-		3704, 3776, 3842, 3900, 3951, 3995, 4031, 4059, 4079, 4091, 4095, 4091,
-		4079, 4059, 4031, 3995, 3951, 3900, 3842, 3776, 3704, 3625, 3540, 3449,
-		3353, 3251, 3145, 3034, 2919, 2801, 2680, 2557, 2431, 2304, 2176, 2047,
-		1919, 1791, 1664, 1538, 1415, 1294, 1176, 1061, 950, 844, 742, 646, 555,
-		470, 391, 319, 253, 195, 144, 100, 64, 36, 16, 4, 0, 4, 16, 36, 64, 100,
-		144, 195, 253, 319, 391, 470, 555, 646, 742, 844, 950, 1061, 1176, 1294,
-		1415, 1538, 1664, 1791, 1919
-};
+#if ( SIG_FRONTEND == SIG_FRONTEND_OVERSAMPLE ) && ( SIG_OVERSAMPLING_RATIO != 16 )
+#error "The oversampler shift assumes 16 conversions per sample"
+#endif
+
+#if FR_RING_LEN < SIG_CAPTURE_BLOCK_COUNT
+#error "The frame ring must hold a descriptor for every block of the capture ring"
+#endif
+
+#if ( SIG_CAPTURE_BLOCK_COUNT < 2 ) || ( INPUT_BUFF_LEN > UINT16_MAX )
+#error "SIG_CAPTURE_BLOCK_COUNT out of range"
+#endif
+
+#if ( SIG_FRONTEND == SIG_FRONTEND_DECIMATE ) && ( ( BUFF_TO_DFT_LEN % SIG_DEC_CHUNK_LEN ) != 0 )
+#error "A block of the capture ring must consist of whole decimated chunks"
+#endif
+
+#if ( SIG_FRONTEND == SIG_FRONTEND_DECIMATE ) && ( DEC_EXTRA_BITS != SIG_CODE_SHIFT )
+#error "The decimator output must have SIG_ADC_BITS bits"
+#endif
+
+/** @brief One TX period in DAC codes, generated from the frequency plan by sig_start(). */
+uint32_t OUTPUT_SINE_SIGNAL[OUTPUT_SINE_SIGNAL_LEN] = {0};
+
+/** @brief One multi-tone TX period in DAC codes, generated from the frequency plan by sig_start(). */
+uint32_t OUTPUT_MULTITONE_SIGNAL[FP_DAC_MT_TABLE_LEN] = {0};
+
+/** @brief Cycles of each multi-tone TX tone per FP_MT_TABLE_LEN samples. */
+const uint8_t OUTPUT_MULTITONE_CYCLES[FP_MT_TONE_COUNT] = FP_MT_TONE_CYCLES;
+
+/** @brief One audio period in DAC codes, generated from the frequency plan by sig_start(). */
+uint32_t OUTPUT_AUDIO_SIGNAL[OUTPUT_SINE_AUDIO_LEN] = {0};
 
 SIG_Handle_t sig_handle = {0};
 
+/** @brief Result of the last sig_polar_benchmark() call. */
+SIG_PolarBenchmark_t sig_polar_benchmark_result = {0};
+
+
+#if SIG_FRONTEND == SIG_FRONTEND_OVERSAMPLE
+/**
+ * @brief Enables the oversampler of an ADC for the regular conversions.
+ *
+ * Every trigger starts SIG_OVERSAMPLING_RATIO conversions back to back, and
+ * their sum is shifted so that the result has SIG_ADC_BITS bits. At the
+ * 1.5 cycle sampling time a 12-bit conversion takes 8 ADC clocks, so the
+ * ADC clock must be at least 8 * SIG_OVERSAMPLING_RATIO times the sample rate.
+ * The ADC must not be converting.
+ *
+ * @param hadc Pointer to the ADC_HandleTypeDef structure.
+ */
+static void sig_config_oversampling(ADC_HandleTypeDef *hadc)
+{
+    LL_ADC_ConfigOverSamplingRatioShift(hadc->Instance, SIG_OVERSAMPLING_RATIO, LL_ADC_OVS_SHIFT_RIGHT_2);
+    LL_ADC_SetOverSamplingDiscont(hadc->Instance, LL_ADC_OVS_REG_CONT);
+    LL_ADC_SetOverSamplingScope(hadc->Instance, LL_ADC_OVS_GRP_REGULAR_CONTINUED);
+}
+#endif
+
 
 /**
  * @brief Initializes and starts the signal processing components.
  *
  * This function initializes the ADC and DAC peripherals, starts the ADC conversion
  * in DMA mode, and begins the DAC output with a sine wave signal. It also starts
- * the timer used for signal processing.
+ * the timer used for signal processing and the cycle counter used for profiling,
+ * and prepares the FFT plans so that no FFT instance is created per block.
+ * The ADCs and the DMA are set up for the front-end selected by SIG_FRONTEND.
  *
  * @param handle Pointer to the SIG_Handle_t structure containing the configuration.
  */
 void sig_start(SIG_Handle_t *const handle)
 {
+    /* Create the FFT plans and window tables once and select the full block length */
+    fft_plan_init(&fft_plan_cache);
+    win_init();
+    sig_set_fft_len(handle, BUFF_TO_DFT_LEN);
+
+    /* Remove the mid-scale offset, the window stays rectangular until selected */
+    handle->dc_offset = ADC_MID_SCALE;
+
+    /* Generate the DAC tables and set the sample rate of the frequency plan */
+    fp_generate_sine(OUTPUT_SINE_SIGNAL, OUTPUT_SINE_SIGNAL_LEN, FP_TX_AMPLITUDE);
+    fp_generate_sine(OUTPUT_AUDIO_SIGNAL, OUTPUT_SINE_AUDIO_LEN, FP_AUDIO_AMPLITUDE);
+    handle->tx_crest_factor = fp_generate_multitone(OUTPUT_MULTITONE_SIGNAL, FP_DAC_MT_TABLE_LEN, OUTPUT_MULTITONE_CYCLES,
+                                                    FP_MT_TONE_COUNT, FP_MT_PEAK_AMPLITUDE);
+    __HAL_TIM_SET_AUTORELOAD(&htim2, FP_TIM_PERIOD - 1);
+
+    /* Start the cycle counter used for profiling and for the frame timestamps */
+    cc_init();
+    fr_init(&handle->frames);
+
     /* Start ADC calibration for ADC1 and ADC2 */
     HAL_ADCEx_Calibration_Start(&hadc1, ADC_CALIB_OFFSET, ADC_SINGLE_ENDED);
     HAL_ADCEx_Calibration_Start(&hadc1, ADC_CALIB_OFFSET_LINEARITY, ADC_SINGLE_ENDED);
     HAL_ADCEx_Calibration_Start(&hadc2, ADC_CALIB_OFFSET, ADC_SINGLE_ENDED);
     HAL_ADCEx_Calibration_Start(&hadc2, ADC_CALIB_OFFSET_LINEARITY, ADC_SINGLE_ENDED);
 
+#if SIG_FRONTEND == SIG_FRONTEND_OVERSAMPLE
+    /* Both ADCs of the dual mode need the same oversampling, all conversions follow one trigger */
+    sig_config_oversampling(&hadc1);
+    sig_config_oversampling(&hadc2);
+#endif
+
     /* Start ADC and DAC in DMA mode */
     HAL_ADC_Start(&hadc2);
-    HAL_ADCEx_MultiModeStart_DMA(&hadc1, (uint32_t *)handle->input_sig, INPUT_BUFF_LEN);
+#if SIG_FRONTEND == SIG_FRONTEND_DECIMATE
+    /* The DMA alternates between two raw blocks, the decimator fills the capture ring */
+    dec_init(&dec_handle);
+    handle->dec_write_index = 0;
+    cap_start(&cap_handle, &hadc1, handle->raw_sig, SIG_DEC_RAW_BLOCK_LEN, 2);
+#else
+    cap_start(&cap_handle, &hadc1, (uint32_t *)handle->input_sig, BUFF_TO_DFT_LEN, SIG_CAPTURE_BLOCK_COUNT);
+#endif
     HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_1, OUTPUT_AUDIO_SIGNAL, OUTPUT_SINE_AUDIO_LEN, DAC_ALIGN_12B_R);
-    HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_2, OUTPUT_SINE_SIGNAL, OUTPUT_SINE_SIGNAL_LEN, DAC_ALIGN_12B_R);
+    sig_set_tx_mode(handle, handle->tx_mode);
+
+#if ( SIG_DEMOD_ENGINE == SIG_DEMOD_SDFT ) && ( SIG_FRONTEND != SIG_FRONTEND_DECIMATE )
+    /* Wake the sliding DFT once per sub-block, counted from the first sample on */
+    cap_tick_start(&cap_handle, &htim3, SDFT_SUBBLOCK_LEN);
+#endif
 
     /* Start the timer */
     HAL_TIM_Base_Start(&htim2);
@@ -69,31 +162,366 @@ void sig_start(SIG_Handle_t *const handle)
 
 
 /**
- * @brief Loads samples into the processing buffers.
+ * @brief Selects the FFT length used by sig_load_samples() and sig_perform_fft().
+ *
+ * This function looks up the cached FFT instance for the new length, so the
+ * length can be switched between two blocks without initializing any instance.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param fft_len New FFT length, a power of two supported by the FFT plan cache.
+ * @return SIG_Status_t SIG_OK if the length was applied, SIG_ERROR if it is not supported.
+ */
+SIG_Status_t sig_set_fft_len(SIG_Handle_t *const handle, uint16_t fft_len)
+{
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+    const arm_rfft_instance_q15 *plan = fft_plan_get_q15(&fft_plan_cache, fft_len);
+
+    /* The processing buffers hold at most BUFF_TO_DFT_LEN samples */
+    if( (plan == NULL) || (fft_len > BUFF_TO_DFT_LEN) )
+    {
+        return SIG_ERROR;
+    }
+#else
+    const arm_rfft_fast_instance_f32 *plan = fft_plan_get(&fft_plan_cache, fft_len);
+    const arm_cfft_instance_f32 *cfft_plan = fft_plan_get_cfft(&fft_plan_cache, fft_len);
+
+    /* The processing buffers hold at most BUFF_TO_DFT_LEN samples */
+    if( (plan == NULL) || (cfft_plan == NULL) || (fft_len > BUFF_TO_DFT_LEN) )
+    {
+        return SIG_ERROR;
+    }
+
+    handle->cfft_plan = cfft_plan;
+    handle->window = win_get(handle->window_type, fft_len);
+#endif
+
+    handle->fft_plan = plan;
+    handle->fft_len = fft_len;
+
+    return SIG_OK;
+}
+
+
+/**
+ * @brief Selects the transform used by sig_load_samples() and sig_perform_fft().
+ *
+ * Both transforms produce the same frequency domain layout, so the mode can be
+ * switched between two blocks without affecting the consumers of the spectra.
+ * The packed transform is only available in the floating point chain, the Q15
+ * chain ignores the mode.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param mode New transform mode.
+ */
+void sig_set_transform_mode(SIG_Handle_t *const handle, SIG_TransformMode_t mode)
+{
+    handle->transform_mode = mode;
+}
+
+
+/**
+ * @brief Selects the window applied by sig_load_samples().
+ *
+ * The window table of the current FFT length is looked up here and again
+ * whenever the length changes, so loading the samples only dereferences the
+ * stored pointer. The windows are only available in the floating point chain.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param type New window function.
+ * @return SIG_Status_t SIG_OK if the window was applied, SIG_ERROR if it is not available.
+ */
+SIG_Status_t sig_set_window(SIG_Handle_t *const handle, WIN_Type_t type)
+{
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+    if (type != WIN_RECTANGULAR)
+    {
+        return SIG_ERROR;
+    }
+#else
+    if (type >= WIN_COUNT)
+    {
+        return SIG_ERROR;
+    }
+
+    handle->window = win_get(type, handle->fft_len);
+#endif
+
+    handle->window_type = type;
+
+    return SIG_OK;
+}
+
+
+/**
+ * @brief Switches the TX coil between the single-tone and the multi-tone signal.
+ *
+ * This function restarts DAC channel 2 with the table of the selected mode.
+ * Both tables are clocked by TIM2, so the ADC sampling is not affected and the
+ * primary tone stays at the same frequency in both modes.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param mode New TX mode.
+ */
+void sig_set_tx_mode(SIG_Handle_t *const handle, SIG_TxMode_t mode)
+{
+    HAL_DAC_Stop_DMA(&hdac1, DAC_CHANNEL_2);
+
+    if (mode == SIG_TX_MULTI)
+    {
+        HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_2, OUTPUT_MULTITONE_SIGNAL, FP_DAC_MT_TABLE_LEN, DAC_ALIGN_12B_R);
+    }
+    else
+    {
+        HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_2, OUTPUT_SINE_SIGNAL, OUTPUT_SINE_SIGNAL_LEN, DAC_ALIGN_12B_R);
+    }
+
+    handle->tx_mode = mode;
+}
+
+
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+/**
+ * @brief Loads samples into the Q15 processing buffers.
  *
- * This function copies samples from the input buffer to the processing buffers for
- * further signal analysis. The samples are loaded based on the provided flag.
+ * This function converts the samples of the given view of the input buffer
+ * to Q15 without any floating point operation. The DC offset is removed and the
+ * result is shifted left by SIG_Q15_INPUT_SHIFT, so with the default offset
+ * the codes 0..ADC_MAX_VALUE map to -32768..32767 or just below. Other offsets saturate.
  *
  * @param handle Pointer to the SIG_Handle_t structure containing the buffers.
- * @param flag Flag indicating the completion status of ADC conversion.
+ * @param view Pointer to the SIG_View_t structure holding the samples.
+ */
+void sig_load_samples(SIG_Handle_t *const handle, const SIG_View_t *const view)
+{
+    /* Remove the offset and scale to Q15 */
+    for(size_t i = 0; i < handle->fft_len; i++)
+    {
+        handle->tx_coil_sig_to_dft[i] = (q15_t) __SSAT( ((int32_t)view->samples[i].adc1 - handle->dc_offset) << SIG_Q15_INPUT_SHIFT, 16 );
+        handle->rx_coil_sig_to_dft[i] = (q15_t) __SSAT( ((int32_t)view->samples[i].adc2 - handle->dc_offset) << SIG_Q15_INPUT_SHIFT, 16 );
+    }
+}
+
+
+/**
+ * @brief Computes atan2(y, x) in Q15 without floating point operations.
+ *
+ * The argument is reduced to the first octant, where atan(z) is approximated by
+ * pi/4 * z + 0.273 * z * (1 - z). The maximum error is 0.004 rad (0.23 deg).
+ *
+ * @param y Imaginary part.
+ * @param x Real part.
+ * @return q15_t Angle divided by pi in Q15, in the range -32768..32767.
  */
-void sig_load_samples(SIG_Handle_t *const handle, uint8_t flag)
+static q15_t sig_atan2_q15(q15_t y, q15_t x)
 {
-    size_t counter = 0;
+    int32_t abs_x = (x < 0) ? -(int32_t)x : x;
+    int32_t abs_y = (y < 0) ? -(int32_t)y : y;
+    int32_t ratio = 0, angle = 0;
 
-    /* Set counter based on ADC conversion completion flag */
-    if (flag == ADC_FULL_COMPLETE_FLAG)
+    if( (abs_x == 0) && (abs_y == 0) )
     {
-        counter = INPUT_BUFF_LEN / 2;
+        return 0;
     }
 
-    /* Copy samples to processing buffers */
-    for(size_t i = 0; i < BUFF_TO_DFT_LEN; i++)
+    /* Angle of the first octant, 8192 corresponds to pi/4 */
+    if (abs_x >= abs_y)
+    {
+        ratio = (abs_y << 15) / abs_x;
+        angle = (ratio >> 2) + ((((ratio * (32768 - ratio)) >> 15) * 2847) >> 15);
+    }
+    else
+    {
+        ratio = (abs_x << 15) / abs_y;
+        angle = 16384 - ((ratio >> 2) + ((((ratio * (32768 - ratio)) >> 15) * 2847) >> 15));
+    }
+
+    /* Restore the quadrant */
+    if (x < 0)
+    {
+        angle = 32768 - angle;
+    }
+    if (y < 0)
+    {
+        angle = -angle;
+    }
+
+    return (q15_t) __SSAT(angle, 16);
+}
+
+
+/**
+ * @brief Performs the Q15 Fast Fourier Transform (FFT) on the signal data.
+ *
+ * arm_rfft_q15() scales the result down by N/2 to avoid overflows in its
+ * stages, which for a full scale input gives a bin value equal to the sine
+ * amplitude in Q15, so no saturation can occur for any supported length.
+ * The TX and RX spectra are computed one after another in the shared spectrum
+ * buffer. Only the TX frequency bin of the TX spectrum is kept, the RX
+ * spectrum stays in the buffer for sig_update_polar(). The index of the
+ * maximum magnitude is found on the squared magnitudes, which the products of
+ * two Q15 values give exactly in 32 bits.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the signal data.
+ * @return size_t Index of the maximum magnitude value in the frequency domain.
+ */
+size_t sig_perform_fft(SIG_Handle_t *const handle)
+{
+    size_t last_max_value_index = 0;
+    uint32_t last_max_value = 0;
+
+    /* Perform FFT on transmit signal, the input buffer is used as scratch */
+    arm_rfft_q15(handle->fft_plan, handle->tx_coil_sig_to_dft, (q15_t *)handle->freq_domain);
+    handle->tx_tx_bin = handle->freq_domain[FP_TX_BIN(handle->fft_len)];
+
+    /* Perform FFT on receive signal, its spectrum is kept */
+    arm_rfft_q15(handle->fft_plan, handle->rx_coil_sig_to_dft, (q15_t *)handle->freq_domain);
+    handle->rx_tx_bin = handle->freq_domain[FP_TX_BIN(handle->fft_len)];
+
+    /* Track maximum magnitude value, the square root is not needed for the comparison */
+    for(size_t i = 11; i < handle->fft_len / 2; i++)
+    {
+        int32_t real = handle->freq_domain[i].real_part;
+        int32_t imag = handle->freq_domain[i].imaginary_part;
+        uint32_t power = (uint32_t)(real * real) + (uint32_t)(imag * imag);
+
+        if (last_max_value < power)
+        {
+            last_max_value = power;
+            last_max_value_index = i;
+        }
+    }
+
+    return last_max_value_index;
+}
+
+
+/**
+ * @brief Computes the polar form of a range of frequency bins of the RX spectrum.
+ *
+ * The magnitudes of the whole range are computed with one arm_cmplx_mag_q15()
+ * call into the RX sample buffer, which arm_rfft_q15() has already used as
+ * scratch, and the phases with the integer atan2. The TX spectrum is not kept
+ * in the Q15 chain, so there is no TX polar form. The range is clipped to the
+ * bins of the current FFT length.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectrum.
+ * @param first Index of the first bin.
+ * @param count Number of bins.
+ */
+void sig_update_polar(SIG_Handle_t *const handle, size_t first, size_t count)
+{
+    q15_t *magnitude = handle->rx_coil_sig_to_dft;
+    size_t end = first + count;
+
+    if (end > handle->fft_len / 2)
+    {
+        end = handle->fft_len / 2;
+    }
+    if (first >= end)
+    {
+        return;
+    }
+
+    /* arm_cmplx_mag_q15() returns 2.14, scale it to ADC codes */
+    arm_cmplx_mag_q15((const q15_t *)&handle->freq_domain[first], magnitude, (uint32_t)(end - first));
+
+    for(size_t i = first; i < end; i++)
+    {
+        handle->rx_coil_polar[i].magnitude = magnitude[i - first] >> SIG_Q15_MAGNITUDE_SHIFT;
+        handle->rx_coil_polar[i].phase = sig_atan2_q15(handle->freq_domain[i].imaginary_part,
+                                                       handle->freq_domain[i].real_part);
+    }
+}
+
+
+/**
+ * @brief Computes the RX and TX magnitudes and the cross spectrum RX * conj(TX) of the TX frequency bin.
+ *
+ * The magnitudes and the cross spectrum are computed in integer arithmetic
+ * from the TX frequency bins kept by sig_perform_fft(), the products of two
+ * Q15 values in 64 bits. MD_Data_t and the detector stages work on float in
+ * every build, so the four results are converted once here, scaled like the
+ * magnitudes of the floating point chain.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectra.
+ * @param cross Pointer to the SIG_CrossSpectrum_t structure that receives the values.
+ */
+void sig_cross_spectrum(const SIG_Handle_t *const handle, SIG_CrossSpectrum_t *const cross)
+{
+    /* A Q15 bin value is 2 << SIG_Q15_MAGNITUDE_SHIFT times the magnitude */
+    const float32_t scale = 1.0f / (float32_t)( (2 << SIG_Q15_MAGNITUDE_SHIFT) * (2 << SIG_Q15_MAGNITUDE_SHIFT) );
+    const int32_t rx_real = handle->rx_tx_bin.real_part, rx_imag = handle->rx_tx_bin.imaginary_part;
+    const int32_t tx_real = handle->tx_tx_bin.real_part, tx_imag = handle->tx_tx_bin.imaginary_part;
+    int64_t cross_real = (int64_t)rx_real * tx_real + (int64_t)rx_imag * tx_imag;
+    int64_t cross_imag = (int64_t)rx_imag * tx_real - (int64_t)rx_real * tx_imag;
+    q15_t magnitude[2] = {0};
+
+    /* arm_cmplx_mag_q15() returns 2.14, scale it to ADC codes */
+    arm_cmplx_mag_q15((const q15_t *)&handle->rx_tx_bin, &magnitude[0], 1);
+    arm_cmplx_mag_q15((const q15_t *)&handle->tx_tx_bin, &magnitude[1], 1);
+
+    cross->rx_magnitude = (float32_t)(magnitude[0] >> SIG_Q15_MAGNITUDE_SHIFT);
+    cross->tx_magnitude = (float32_t)(magnitude[1] >> SIG_Q15_MAGNITUDE_SHIFT);
+    cross->real_part = (float32_t)cross_real * scale;
+    cross->imaginary_part = (float32_t)cross_imag * scale;
+}
+#else
+/**
+ * @brief Loads samples into the processing buffers.
+ *
+ * This function converts samples from the input buffer to the processing buffers
+ * for further signal analysis with the fused kernel from load_kernel.h, which
+ * removes the DC offset and applies the window in the same pass. The samples are
+ * read directly from the view of the DMA buffer, and only as many samples as
+ * the current FFT length are converted. For the packed transform the TX and RX samples are
+ * interleaved as complex values.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the buffers.
+ * @param view Pointer to the SIG_View_t structure holding the samples.
+ */
+void sig_load_samples(SIG_Handle_t *const handle, const SIG_View_t *const view)
+{
+    LK_Params_t params = {0};
+
+    params.src = (const uint32_t *)view->samples;
+    params.window = handle->window;
+    params.dc_offset = handle->dc_offset;
+    params.len = handle->fft_len;
+
+    if (handle->transform_mode == SIG_TRANSFORM_PACKED)
+    {
+        /* Convert samples as TX + j * RX */
+        params.tx_out = &handle->packed_sig_to_dft[0];
+        params.rx_out = &handle->packed_sig_to_dft[1];
+        params.stride = 2;
+    }
+    else
     {
-        handle->tx_coil_sig_to_dft[i] = ( (float32_t) handle->input_sig[counter].adc1 );
-        handle->rx_coil_sig_to_dft[i] = ( (float32_t) handle->input_sig[counter].adc2 );
-        counter++;
+        /* Convert samples to separate processing buffers */
+        params.tx_out = handle->tx_coil_sig_to_dft;
+        params.rx_out = handle->rx_coil_sig_to_dft;
+        params.stride = 1;
     }
+
+    lk_convert(&params);
+}
+
+
+/**
+ * @brief Computes the spectra of both coils with one complex FFT.
+ *
+ * The packed buffer holds z[n] = tx[n] + j * rx[n]. After the complex FFT,
+ * pfft_split() takes both spectra out of the spectrum of z, in the same layout
+ * as produced by arm_rfft_fast_f32().
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the signal data.
+ */
+static void sig_perform_packed_fft(SIG_Handle_t *const handle)
+{
+    arm_cfft_f32(handle->cfft_plan, handle->packed_sig_to_dft, 0, 1);
+
+    pfft_split(handle->packed_sig_to_dft, handle->fft_len, (float32_t *)handle->tx_coil_freq_domain,
+               (float32_t *)handle->rx_coil_freq_domain);
 }
 
 
@@ -101,75 +529,331 @@ void sig_load_samples(SIG_Handle_t *const handle, uint8_t flag)
  * @brief Performs Fast Fourier Transform (FFT) on the signal data.
  *
  * This function calculates the FFT of the input signals for both the receive and
- * transmit coils. It then computes the magnitude and phase of the frequency domain
- * data and returns the index of the maximum magnitude value.
+ * transmit coils using the cached FFT instance of the current length, either as
+ * two real FFTs or as one packed complex FFT. The polar form is not computed
+ * here, the consumers request the bins they need with sig_update_polar().
+ * The index of the maximum magnitude is found on the squared magnitudes.
  *
  * @param handle Pointer to the SIG_Handle_t structure containing the signal data.
  * @return size_t Index of the maximum magnitude value in the frequency domain.
  */
 size_t sig_perform_fft(SIG_Handle_t *const handle)
 {
-    arm_rfft_fast_instance_f32 rx_fft_instance = {0};
-    arm_rfft_fast_instance_f32 tx_fft_instance = {0};
-    size_t last_max_value = 0, last_max_value_index = 0, magnitude = 0;
-
-    /* Initialize FFT instances */
-    arm_rfft_fast_init_f32(&rx_fft_instance, BUFF_TO_DFT_LEN);
-    arm_rfft_fast_init_f32(&tx_fft_instance, BUFF_TO_DFT_LEN);
+    size_t last_max_value_index = 0;
+    float32_t last_max_value = 0;
 
     /* Perform FFT on receive and transmit signals */
-    arm_rfft_fast_f32(&rx_fft_instance, (float32_t *)handle->rx_coil_sig_to_dft, (float32_t *)handle->rx_coil_freq_domain, 0);
-    arm_rfft_fast_f32(&tx_fft_instance, (float32_t *)handle->tx_coil_sig_to_dft, (float32_t *)handle->tx_coil_freq_domain, 0);
+    if (handle->transform_mode == SIG_TRANSFORM_PACKED)
+    {
+        sig_perform_packed_fft(handle);
+    }
+    else
+    {
+        arm_rfft_fast_f32((arm_rfft_fast_instance_f32 *)handle->fft_plan, (float32_t *)handle->rx_coil_sig_to_dft, (float32_t *)handle->rx_coil_freq_domain, 0);
+        arm_rfft_fast_f32((arm_rfft_fast_instance_f32 *)handle->fft_plan, (float32_t *)handle->tx_coil_sig_to_dft, (float32_t *)handle->tx_coil_freq_domain, 0);
+    }
 
-    /* Compute magnitude and phase for each frequency bin */
-    for(size_t i = 0; i < FREQ_DOMAIN_LEN; i++)
+    /* Track maximum magnitude value, the square root is not needed for the comparison */
+    for(size_t i = 11; i < handle->fft_len / 2; i++)
     {
-        magnitude = sqrtf(handle->rx_coil_freq_domain[i].real_part * handle->rx_coil_freq_domain[i].real_part +
-                          handle->rx_coil_freq_domain[i].imaginary_part * handle->rx_coil_freq_domain[i].imaginary_part)
-                    / BUFF_TO_DFT_LEN;
+        float32_t power = handle->rx_coil_freq_domain[i].real_part * handle->rx_coil_freq_domain[i].real_part +
+                          handle->rx_coil_freq_domain[i].imaginary_part * handle->rx_coil_freq_domain[i].imaginary_part;
 
-        /* Track maximum magnitude value */
-        if (last_max_value < magnitude && i > 10)
+        if (last_max_value < power)
         {
-            last_max_value = magnitude;
+            last_max_value = power;
             last_max_value_index = i;
         }
-
-        handle->rx_coil_polar[i].magnitude = magnitude;
-        handle->rx_coil_polar[i].phase = atan2f(handle->rx_coil_freq_domain[i].imaginary_part, handle->rx_coil_freq_domain[i].real_part);
-        handle->tx_coil_polar[i].phase = atan2f(handle->tx_coil_freq_domain[i].imaginary_part, handle->tx_coil_freq_domain[i].real_part);
     }
 
     return last_max_value_index;
 }
 
 
+/**
+ * @brief Computes the polar form of a range of frequency bins.
+ *
+ * This function converts only the requested bins of the last spectra, so the
+ * cost follows the number of bins that are actually read. The RX magnitudes
+ * are computed in chunks with arm_cmplx_mag_f32() and the phases with
+ * fm_atan2f(), whose error is below 1.2e-5 rad. The range is clipped to the
+ * bins of the current FFT length.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectra.
+ * @param first Index of the first bin.
+ * @param count Number of bins.
+ */
+void sig_update_polar(SIG_Handle_t *const handle, size_t first, size_t count)
+{
+    float32_t magnitude[SIG_POLAR_CHUNK_LEN];
+    const float32_t scale = 1.0f / (float32_t)( (uint32_t)handle->fft_len << SIG_CODE_SHIFT );
+    size_t end = first + count;
+
+    if (end > handle->fft_len / 2)
+    {
+        end = handle->fft_len / 2;
+    }
+
+    for(size_t i = first; i < end; i += SIG_POLAR_CHUNK_LEN)
+    {
+        size_t len = ( (end - i) < SIG_POLAR_CHUNK_LEN ) ? (end - i) : SIG_POLAR_CHUNK_LEN;
+
+        arm_cmplx_mag_f32((const float32_t *)&handle->rx_coil_freq_domain[i], magnitude, (uint32_t)len);
+
+        for(size_t k = 0; k < len; k++)
+        {
+            handle->rx_coil_polar[i + k].magnitude = magnitude[k] * scale;
+            handle->rx_coil_polar[i + k].phase = fm_atan2f(handle->rx_coil_freq_domain[i + k].imaginary_part, handle->rx_coil_freq_domain[i + k].real_part);
+            handle->tx_coil_polar[i + k].phase = fm_atan2f(handle->tx_coil_freq_domain[i + k].imaginary_part, handle->tx_coil_freq_domain[i + k].real_part);
+        }
+    }
+}
+
+
+/**
+ * @brief Computes the RX and TX magnitudes and the cross spectrum RX * conj(TX) of the TX frequency bin.
+ *
+ * The phase difference is later taken as the angle of the cross spectrum, so
+ * no arctangent is computed here, and the polar form of the bin is not needed.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectra.
+ * @param cross Pointer to the SIG_CrossSpectrum_t structure that receives the values.
+ */
+void sig_cross_spectrum(const SIG_Handle_t *const handle, SIG_CrossSpectrum_t *const cross)
+{
+    const float32_t scale = 1.0f / (float32_t)( (uint32_t)handle->fft_len << SIG_CODE_SHIFT );
+    const SIG_FreqDomain_t *rx = &handle->rx_coil_freq_domain[FP_TX_BIN(handle->fft_len)];
+    const SIG_FreqDomain_t *tx = &handle->tx_coil_freq_domain[FP_TX_BIN(handle->fft_len)];
+    float32_t rx_real = rx->real_part * scale;
+    float32_t rx_imag = rx->imaginary_part * scale;
+    float32_t tx_real = tx->real_part * scale;
+    float32_t tx_imag = tx->imaginary_part * scale;
+
+    cross->rx_magnitude = sqrtf(rx_real * rx_real + rx_imag * rx_imag);
+    cross->tx_magnitude = sqrtf(tx_real * tx_real + tx_imag * tx_imag);
+    cross->real_part = rx_real * tx_real + rx_imag * tx_imag;
+    cross->imaginary_part = rx_imag * tx_real - rx_real * tx_imag;
+}
+
+
+/**
+ * @brief Measures the cost of the polar conversion of one bin against all bins.
+ *
+ * The cycle counter must be enabled with cc_init() beforehand.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure containing the spectra.
+ * @param result Pointer to the SIG_PolarBenchmark_t structure that receives the cycle counts.
+ */
+void sig_polar_benchmark(SIG_Handle_t *const handle, SIG_PolarBenchmark_t *const result)
+{
+    uint32_t start = 0;
+
+    start = cc_get();
+    sig_update_polar(handle, FP_TX_BIN(handle->fft_len), 1);
+    result->bin_cycles = cc_get() - start;
+
+    start = cc_get();
+    sig_update_polar(handle, 0, handle->fft_len / 2);
+    result->all_cycles = cc_get() - start;
+}
+
+
+#endif /* SIG_ARITHMETIC */
+
+
+/**
+ * @brief Returns the index of the next input buffer entry the DMA will write.
+ *
+ * The index is derived from the memory register and the remaining transfer
+ * count of the capture DMA stream, so all entries before it (modulo
+ * INPUT_BUFF_LEN) hold new samples. With the decimating front-end the
+ * entries are written by the decimator, one chunk of SIG_DEC_CHUNK_LEN
+ * samples at a time.
+ *
+ * @return uint16_t Write index in the range 0..INPUT_BUFF_LEN - 1.
+ */
+uint16_t sig_get_write_index(void)
+{
+#if SIG_FRONTEND == SIG_FRONTEND_DECIMATE
+    return sig_handle.dec_write_index;
+#else
+    return (uint16_t) cap_get_write_index(&cap_handle);
+#endif
+}
+
+
+/**
+ * @brief Takes ownership of a completed block of the capture ring.
+ *
+ * The view points directly into the DMA buffer, no samples are copied. The
+ * block is marked as owned before the sequence number of the frame is checked,
+ * so an ADC interrupt that fires in between is always noticed. If the DMA has
+ * gone around the ring and is already writing into the block again, the view
+ * is refused.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param frame Pointer to the FR_Descriptor_t structure popped from the frame ring.
+ * @param view Pointer to the SIG_View_t structure that receives the view.
+ * @return SIG_Status_t SIG_OK if the view is valid, SIG_ERROR if the block is already being overwritten.
+ */
+SIG_Status_t sig_view_acquire(SIG_Handle_t *const handle, const FR_Descriptor_t *const frame, SIG_View_t *const view)
+{
+    uint8_t block = frame->block;
+    uint32_t lag = 0;
+
+    handle->view_torn[block] = 0;
+    handle->view_owned[block] = 1;
+    __DMB();
+
+    view->samples = &handle->input_sig[block * BUFF_TO_DFT_LEN];
+    view->len = BUFF_TO_DFT_LEN;
+    view->block = block;
+    view->sequence = frame->sequence;
+
+    /* Number of blocks completed after this one */
+    lag = handle->view_sequence - view->sequence;
+    if (lag > handle->view_max_lag)
+    {
+        handle->view_max_lag = lag;
+    }
+
+    if (lag >= SIG_CAPTURE_BLOCK_COUNT - 1)
+    {
+        handle->view_owned[block] = 0;
+        handle->view_late++;
+        return SIG_ERROR;
+    }
+
+    return SIG_OK;
+}
+
+
+/**
+ * @brief Returns a view to the DMA and reports whether it stayed intact.
+ *
+ * All results computed from the view must be discarded if this function
+ * returns SIG_ERROR, because the samples changed while they were read.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure returned by sig_view_acquire().
+ * @return SIG_Status_t SIG_OK if the samples were not overwritten while the view was held.
+ */
+SIG_Status_t sig_view_release(SIG_Handle_t *const handle, const SIG_View_t *const view)
+{
+    __DMB();
+    handle->view_owned[view->block] = 0;
+
+    return (handle->view_torn[view->block] != 0) ? SIG_ERROR : SIG_OK;
+}
+
+
+/**
+ * @brief Copies the start of a view for the time domain chart.
+ *
+ * The GUI task must not read the DMA buffer itself, so the samples shown by
+ * the chart are copied while the view is held. The copies alternate between
+ * two buffers and snapshot_index tells the reader which one is complete.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure holding the samples.
+ */
+void sig_view_snapshot(SIG_Handle_t *const handle, const SIG_View_t *const view)
+{
+    uint8_t next = handle->snapshot_index ^ 1;
+
+    memcpy(handle->snapshot[next], view->samples, sizeof(handle->snapshot[next]));
+    __DMB();
+    handle->snapshot_index = next;
+}
+
+
+/**
+ * @brief Hands a completed block of the capture ring to the consumer.
+ *
+ * Called from the ADC interrupt. Once a block is completed the DMA continues
+ * with the next block of the ring, so a view of that block that is still held
+ * is marked as torn. The completed block is then pushed to the frame ring with
+ * a new sequence number and the signal processing task is woken up.
+ *
+ * @param handle Pointer to the SIG_Handle_t structure.
+ * @param block Index of the completed block.
+ */
+static void sig_view_publish(SIG_Handle_t *const handle, uint8_t block)
+{
+    uint8_t next = (block + 1 == SIG_CAPTURE_BLOCK_COUNT) ? 0 : block + 1;
+    FR_Descriptor_t frame = {0};
+
+    if (handle->view_owned[next] != 0)
+    {
+        handle->view_torn[next] = 1;
+        handle->view_overruns++;
+    }
+
+    frame.sequence = ++handle->view_sequence;
+    frame.timestamp = cc_get();
+    frame.block = block;
+
+    /* A full ring counts the frame as dropped */
+    (void) fr_push(&handle->frames, &frame);
+    osThreadFlagsSet(SignalProcessingHandle, FR_THREAD_FLAG);
+}
+
+
 /**
  * @brief Callback function for ADC conversion complete interrupt.
  *
- * This function is called when the ADC conversion is complete. It places a flag
- * in the message queue to indicate that the ADC data is ready for processing.
+ * This function is called by the capture ring whenever the DMA completed a
+ * block. It publishes the block to the signal processing task. With the
+ * decimating front-end the DMA block is a raw chunk instead, which is
+ * decimated into the capture ring, and a block is published once its last
+ * chunk was written. The sliding DFT is woken up after every chunk then.
  *
  * @param hadc Pointer to the ADC_HandleTypeDef structure.
  */
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
-    uint8_t flag = (uint8_t) ADC_FULL_COMPLETE_FLAG;
-    osMessageQueuePut(InputFlagQueueHandle, &flag, 0, 0);
+#if SIG_FRONTEND == SIG_FRONTEND_DECIMATE
+    SIG_Handle_t *handle = &sig_handle;
+    uint32_t index = handle->dec_write_index;
+
+    dec_process(&dec_handle, &handle->raw_sig[(uint32_t)cap_handle.completed_block * SIG_DEC_RAW_BLOCK_LEN],
+                (uint32_t *)&handle->input_sig[index], SIG_DEC_RAW_BLOCK_LEN);
+
+    index += SIG_DEC_CHUNK_LEN;
+    if (index >= INPUT_BUFF_LEN)
+    {
+        index = 0;
+    }
+    handle->dec_write_index = (uint16_t)index;
+
+    if ( (index % BUFF_TO_DFT_LEN) == 0 )
+    {
+        /* The block before the write index is complete */
+        sig_view_publish(handle, (index == 0 ? SIG_CAPTURE_BLOCK_COUNT : index / BUFF_TO_DFT_LEN) - 1);
+    }
+
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_SDFT
+    /* Every chunk holds new sub-blocks for the sliding DFT */
+    osThreadFlagsSet(SignalProcessingHandle, SDFT_THREAD_FLAG);
+#endif
+#else
+    sig_view_publish(&sig_handle, cap_handle.completed_block);
+#endif
 }
 
 
 /**
- * @brief Callback function for ADC half conversion complete interrupt.
+ * @brief Callback function for the compare interrupt of the capture tick timer.
  *
- * This function is called when half of the ADC conversion is complete. It places a flag
- * in the message queue to indicate that the first half of the ADC data is ready for processing.
+ * The tick runs only with the sliding DFT, and wakes up the signal processing
+ * task once per sub-block, right after the DMA wrote its last sample.
  *
- * @param hadc Pointer to the ADC_HandleTypeDef structure.
+ * @param htim Pointer to the TIM_HandleTypeDef structure.
  */
-void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
 {
-    uint8_t flag = (uint8_t) ADC_HALF_COMPLETE_FLAG;
-    osMessageQueuePut(InputFlagQueueHandle, &flag, 0, 0);
+    if (htim == cap_handle.tick)
+    {
+        osThreadFlagsSet(SignalProcessingHandle, SDFT_THREAD_FLAG);
+    }
 }
-
@@ -0,0 +1,269 @@
+/**
+ * @file capture.c
+ * @brief Implementation file for the multi-block ADC capture ring.
+ *
+ * This file contains the start-up of the dual ADC with a double-buffered DMA
+ * stream and the block switching. When the DMA completes the block of one
+ * memory address register it continues with the other one by itself, and
+ * the transfer complete interrupt re-points the idle register to the next
+ * block of the ring, a whole block period before the DMA needs it. The tick
+ * timer counts the same trigger as the ADC, so its interrupts stay locked to
+ * the samples written into the ring.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include "capture.h"
+
+/** @brief Global handle for the capture ring. */
+CAP_Handle_t cap_handle = {0};
+
+
+/**
+ * @brief Enables the ADC and waits until it is ready.
+ *
+ * This is what the HAL does before it starts conversions, done with the LL
+ * functions, as the HAL keeps its own version private. The slave ADC of the
+ * dual mode sets no ready flag of its own, the master one is waited for.
+ *
+ * @param hadc Pointer to the ADC_HandleTypeDef structure.
+ * @return HAL_StatusTypeDef HAL_OK if the ADC is enabled, HAL_ERROR if it cannot be enabled.
+ */
+static HAL_StatusTypeDef cap_adc_enable(ADC_HandleTypeDef *hadc)
+{
+    uint32_t tickstart = 0;
+
+    if (LL_ADC_IsEnabled(hadc->Instance) != 0UL)
+    {
+        return HAL_OK;
+    }
+
+    if ( (hadc->Instance->CR & (ADC_CR_ADCAL | ADC_CR_JADSTP | ADC_CR_ADSTP | ADC_CR_JADSTART | ADC_CR_ADSTART |
+                                ADC_CR_ADDIS | ADC_CR_ADEN)) != 0UL )
+    {
+        SET_BIT(hadc->State, HAL_ADC_STATE_ERROR_INTERNAL);
+        SET_BIT(hadc->ErrorCode, HAL_ADC_ERROR_INTERNAL);
+        return HAL_ERROR;
+    }
+
+    LL_ADC_Enable(hadc->Instance);
+    tickstart = HAL_GetTick();
+
+    if ( (__LL_ADC_MULTI_INSTANCE_MASTER(hadc->Instance) != hadc->Instance) &&
+         (LL_ADC_GetMultimode(__LL_ADC_COMMON_INSTANCE(hadc->Instance)) != LL_ADC_MULTI_INDEPENDENT) )
+    {
+        return HAL_OK;
+    }
+
+    while (LL_ADC_IsActiveFlag_ADRDY(hadc->Instance) == 0UL)
+    {
+        /* An enable right after the calibration is cleared by it, it is repeated until the ADC is ready */
+        if (LL_ADC_IsEnabled(hadc->Instance) == 0UL)
+        {
+            LL_ADC_Enable(hadc->Instance);
+        }
+
+        if ( ((HAL_GetTick() - tickstart) > CAP_ADC_ENABLE_TIMEOUT_MS) && (LL_ADC_IsActiveFlag_ADRDY(hadc->Instance) == 0UL) )
+        {
+            SET_BIT(hadc->State, HAL_ADC_STATE_ERROR_INTERNAL);
+            SET_BIT(hadc->ErrorCode, HAL_ADC_ERROR_INTERNAL);
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_OK;
+}
+
+
+/**
+ * @brief DMA error callback of the ADC stream, reports the error to the ADC.
+ *
+ * @param hdma Pointer to the DMA_HandleTypeDef structure of the ADC stream.
+ */
+static void cap_dma_error(DMA_HandleTypeDef *hdma)
+{
+    ADC_HandleTypeDef *hadc = (ADC_HandleTypeDef *)hdma->Parent;
+
+    SET_BIT(hadc->State, HAL_ADC_STATE_ERROR_DMA);
+    SET_BIT(hadc->ErrorCode, HAL_ADC_ERROR_DMA);
+    HAL_ADC_ErrorCallback(hadc);
+}
+
+
+/**
+ * @brief Advances the ring after the DMA completed the block of one memory register.
+ *
+ * @param hdma Pointer to the DMA_HandleTypeDef structure of the ADC stream.
+ * @param memory Memory address register whose block was completed.
+ */
+static void cap_block_complete(DMA_HandleTypeDef *hdma, HAL_DMA_MemoryTypeDef memory)
+{
+    CAP_Handle_t *handle = &cap_handle;
+    uint8_t completed = handle->dma_block;
+    uint8_t next = completed + 2;
+
+    if (next >= handle->block_count)
+    {
+        next -= handle->block_count;
+    }
+
+    /* The DMA moved on to the other register, the idle one gets the block after next */
+    handle->dma_block = (completed + 1 == handle->block_count) ? 0 : completed + 1;
+    HAL_DMAEx_ChangeMemory(hdma, (uint32_t)&handle->buffer[(uint32_t)next * handle->block_len], memory);
+
+    handle->completed_block = completed;
+    handle->completed++;
+
+    HAL_ADC_ConvCpltCallback((ADC_HandleTypeDef *)hdma->Parent);
+}
+
+
+/**
+ * @brief DMA transfer complete callback for the block of memory register 0.
+ *
+ * @param hdma Pointer to the DMA_HandleTypeDef structure of the ADC stream.
+ */
+static void cap_dma_m0_complete(DMA_HandleTypeDef *hdma)
+{
+    cap_block_complete(hdma, MEMORY0);
+}
+
+
+/**
+ * @brief DMA transfer complete callback for the block of memory register 1.
+ *
+ * @param hdma Pointer to the DMA_HandleTypeDef structure of the ADC stream.
+ */
+static void cap_dma_m1_complete(DMA_HandleTypeDef *hdma)
+{
+    cap_block_complete(hdma, MEMORY1);
+}
+
+
+/**
+ * @brief Starts the dual ADC conversions into the capture ring.
+ *
+ * This function does what HAL_ADCEx_MultiModeStart_DMA() does, except that the
+ * DMA stream is started in double-buffer mode on the first two blocks. Every
+ * completed block is reported through HAL_ADC_ConvCpltCallback(), with its
+ * index in completed_block. The slave ADC must have been enabled before, and
+ * the conversions begin with the first trigger of the master ADC. Only public
+ * HAL and LL functions are used, so no HAL-internal function is relied upon.
+ *
+ * @param handle Pointer to the CAP_Handle_t structure.
+ * @param hadc Pointer to the ADC_HandleTypeDef structure of the master ADC.
+ * @param buffer Ring of block_len * block_count words.
+ * @param block_len Number of samples per block.
+ * @param block_count Number of blocks in the ring, at least 2.
+ * @return HAL_StatusTypeDef HAL_OK if the conversions were started.
+ */
+HAL_StatusTypeDef cap_start(CAP_Handle_t *const handle, ADC_HandleTypeDef *hadc, uint32_t *buffer,
+                            uint16_t block_len, uint8_t block_count)
+{
+    DMA_HandleTypeDef *hdma = hadc->DMA_Handle;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if( (block_count < 2) || (LL_ADC_REG_IsConversionOngoing(hadc->Instance) != 0UL) )
+    {
+        return HAL_ERROR;
+    }
+
+    handle->hadc = hadc;
+    handle->buffer = buffer;
+    handle->block_len = block_len;
+    handle->block_count = block_count;
+    handle->dma_block = 0;
+    handle->completed_block = 0;
+    handle->completed = 0;
+
+    status = cap_adc_enable(hadc);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    MODIFY_REG(hadc->State,
+               (HAL_ADC_STATE_READY | HAL_ADC_STATE_REG_EOC | HAL_ADC_STATE_REG_OVR | HAL_ADC_STATE_REG_EOSMP),
+               HAL_ADC_STATE_REG_BUSY);
+    hadc->ErrorCode = HAL_ADC_ERROR_NONE;
+
+    /* Report whole blocks only, the half transfer interrupt stays disabled */
+    hdma->XferCpltCallback = cap_dma_m0_complete;
+    hdma->XferM1CpltCallback = cap_dma_m1_complete;
+    hdma->XferHalfCpltCallback = NULL;
+    hdma->XferM1HalfCpltCallback = NULL;
+    hdma->XferErrorCallback = cap_dma_error;
+
+    __HAL_ADC_CLEAR_FLAG(hadc, (ADC_FLAG_EOC | ADC_FLAG_EOS | ADC_FLAG_OVR));
+    __HAL_ADC_ENABLE_IT(hadc, ADC_IT_OVR);
+
+    /* Block 0 in memory register 0 and block 1 in memory register 1 */
+    status = HAL_DMAEx_MultiBufferStart_IT(hdma, (uint32_t)&__LL_ADC_COMMON_INSTANCE(hadc->Instance)->CDR,
+                                           (uint32_t)&buffer[0], (uint32_t)&buffer[block_len], block_len);
+    if (status == HAL_OK)
+    {
+        LL_ADC_REG_StartConversion(hadc->Instance);
+    }
+
+    return status;
+}
+
+
+/**
+ * @brief Starts the tick timer that interrupts once per given number of samples.
+ *
+ * The timer is set up by CubeMX (TIM3 in software.ioc) in external clock mode
+ * on its internal trigger ITR1, so it counts the trigger output of TIM2, one
+ * per ADC sample. Its compare interrupt reports every tick through
+ * HAL_TIM_OC_DelayElapsedCallback() with the tick handle. Only the period is
+ * set here, the one of software.ioc matches SDFT_SUBBLOCK_LEN. The timer must
+ * be started before TIM2, so its count starts with the first sample of the
+ * ring. The compare value of 1 puts the tick one trigger after a boundary of
+ * the given pieces, when the last sample of the piece has been converted and
+ * written already. The first tick comes with the first sample and finds no
+ * complete piece yet.
+ *
+ * @param handle Pointer to the CAP_Handle_t structure.
+ * @param htim Pointer to the TIM_HandleTypeDef structure of the tick timer, set up by MX_TIM3_Init().
+ * @param samples Number of samples between two ticks, a divisor of the block length.
+ * @return HAL_StatusTypeDef HAL_OK if the timer was started.
+ */
+HAL_StatusTypeDef cap_tick_start(CAP_Handle_t *const handle, TIM_HandleTypeDef *htim, uint16_t samples)
+{
+    handle->tick = htim;
+
+    __HAL_TIM_SET_AUTORELOAD(htim, (uint32_t)samples - 1U);
+    __HAL_TIM_SET_COUNTER(htim, 0);
+
+    return HAL_TIM_OC_Start_IT(htim, TIM_CHANNEL_1);
+}
+
+
+/**
+ * @brief Returns the index of the next ring entry the DMA will write.
+ *
+ * The block is taken from the memory register the DMA is using, so the index
+ * stays right even between a block switch and its interrupt. The register
+ * selection is read again after the transfer count, and the read is repeated
+ * if the DMA switched blocks in between.
+ *
+ * @param handle Pointer to the CAP_Handle_t structure.
+ * @return uint32_t Write index in the range 0..block_len * block_count - 1.
+ */
+uint32_t cap_get_write_index(const CAP_Handle_t *const handle)
+{
+    DMA_Stream_TypeDef *stream = (DMA_Stream_TypeDef *)handle->hadc->DMA_Handle->Instance;
+    uint32_t ring_len = (uint32_t)handle->block_len * handle->block_count;
+    uint32_t target = 0, remaining = 0, address = 0;
+
+    do
+    {
+        target = stream->CR & DMA_SxCR_CT;
+        remaining = stream->NDTR;
+    } while ( (stream->CR & DMA_SxCR_CT) != target );
+
+    address = (target != 0) ? stream->M1AR : stream->M0AR;
+
+    return ( (uint32_t)( (uint32_t *)address - handle->buffer ) + handle->block_len - remaining ) % ring_len;
+}
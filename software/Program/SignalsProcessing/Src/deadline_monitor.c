@@ -0,0 +1,184 @@
+/**
+ * @file deadline_monitor.c
+ * @brief Implementation file for the run-time deadline monitor of the signal pipeline.
+ *
+ * This file contains the recording of the frame latencies and the evaluation
+ * of the statistics. All values are kept in CPU cycles and only converted to
+ * microseconds when the statistics are read. The percentile is taken from the
+ * histogram, so its resolution is one bin width, 1/DM_BINS_PER_PERIOD of
+ * the deadline.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <string.h>
+#include "arm_math.h"
+#include "main.h"
+#include "deadline_monitor.h"
+
+/** @brief Global deadline monitor of the signal processing task. */
+DM_Handle_t dm_handle = {0};
+
+
+/**
+ * @brief Clears the statistics, to be called by the writer only.
+ *
+ * @param handle Pointer to the DM_Handle_t structure.
+ */
+static void dm_clear(DM_Handle_t *const handle)
+{
+    memset(handle->histogram, 0, sizeof(handle->histogram));
+    handle->count = 0;
+    handle->misses = 0;
+    handle->min_latency = UINT32_MAX;
+    handle->max_latency = 0;
+    handle->latency_sum = 0;
+    handle->busy_sum = 0;
+    handle->reset_request = 0;
+}
+
+
+/**
+ * @brief Sets the deadline and clears the statistics.
+ *
+ * Must be called before the first frame is recorded.
+ *
+ * @param handle Pointer to the DM_Handle_t structure.
+ * @param period_cycles Deadline of a frame after its release, in CPU cycles.
+ */
+void dm_init(DM_Handle_t *const handle, uint32_t period_cycles)
+{
+    handle->period = period_cycles;
+    handle->bin_width = (period_cycles + DM_BINS_PER_PERIOD - 1) / DM_BINS_PER_PERIOD;
+    handle->version = 0;
+    dm_clear(handle);
+}
+
+
+/**
+ * @brief Records one processed frame, to be called by the signal processing task only.
+ *
+ * The latency runs from the release to the end of the processing, the time
+ * the frame waited in the ring included. A frame misses its deadline if its
+ * latency exceeds one period, since the next frame is released by then.
+ *
+ * @param handle Pointer to the DM_Handle_t structure.
+ * @param release Cycle counter value when the frame became available.
+ * @param start Cycle counter value when its processing started.
+ * @param end Cycle counter value when its processing ended.
+ */
+void dm_record(DM_Handle_t *const handle, uint32_t release, uint32_t start, uint32_t end)
+{
+    uint32_t latency = end - release;
+    uint32_t bin = latency / handle->bin_width;
+
+    /* Mark the record as in progress for the readers */
+    handle->version++;
+    __DMB();
+
+    if (handle->reset_request)
+    {
+        dm_clear(handle);
+    }
+
+    handle->histogram[(bin < DM_HIST_BINS) ? bin : (DM_HIST_BINS - 1)]++;
+    handle->count++;
+    handle->latency_sum += latency;
+    handle->busy_sum += end - start;
+
+    if (latency < handle->min_latency)
+    {
+        handle->min_latency = latency;
+    }
+
+    if (latency > handle->max_latency)
+    {
+        handle->max_latency = latency;
+    }
+
+    if (latency > handle->period)
+    {
+        handle->misses++;
+    }
+
+    __DMB();
+    handle->version++;
+}
+
+
+/**
+ * @brief Requests the statistics to be cleared with the next record.
+ *
+ * The statistics are not cleared here, so this function can be called from
+ * any task without racing the writer.
+ *
+ * @param handle Pointer to the DM_Handle_t structure.
+ */
+void dm_reset(DM_Handle_t *const handle)
+{
+    handle->reset_request = 1;
+}
+
+
+/**
+ * @brief Returns a consistent copy of the statistics, to be called from a task of lower priority than the writer.
+ *
+ * The statistics are copied again if a record was written during the copy.
+ * As the writer has the higher priority, it always completes its record
+ * before the reader runs again, so the copy is repeated at most once per
+ * frame.
+ *
+ * @param handle Pointer to the DM_Handle_t structure.
+ * @param stats Pointer to the DM_Stats_t structure that receives the statistics.
+ */
+void dm_get_stats(const DM_Handle_t *const handle, DM_Stats_t *const stats)
+{
+    DM_Handle_t copy;
+    uint32_t version = 0;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000UL;
+    uint32_t bin = 0, rank = 0, frames = 0;
+
+    do
+    {
+        version = handle->version;
+        __DMB();
+        memcpy(&copy, handle, sizeof(DM_Handle_t));
+        __DMB();
+    } while ( (version & 1) || (handle->version != version) );
+
+    memset(stats, 0, sizeof(DM_Stats_t));
+    stats->period_us = copy.period / cycles_per_us;
+
+    if (copy.count == 0)
+    {
+        return;
+    }
+
+    stats->count = copy.count;
+    stats->misses = copy.misses;
+    stats->min_us = copy.min_latency / cycles_per_us;
+    stats->max_us = copy.max_latency / cycles_per_us;
+    stats->avg_us = (uint32_t)( copy.latency_sum / copy.count ) / cycles_per_us;
+    stats->avg_busy_us = (uint32_t)( copy.busy_sum / copy.count ) / cycles_per_us;
+    stats->load_percent = (uint32_t)( ( copy.busy_sum * 100U ) / ( (uint64_t)copy.count * copy.period ) );
+
+    /* Smallest number of frames that holds the percentile, then the bin that reaches it */
+    rank = (uint32_t)( ( (uint64_t)copy.count * DM_PERCENTILE + 99U ) / 100U );
+    for (bin = 0; bin < DM_HIST_BINS - 1; bin++)
+    {
+        frames += copy.histogram[bin];
+        if (frames >= rank)
+        {
+            break;
+        }
+    }
+
+    /* The upper edge of the bin, but never more than the longest latency */
+    stats->p99_us = ( (bin < DM_HIST_BINS - 1) ? ( (bin + 1) * copy.bin_width ) : copy.max_latency );
+    if (stats->p99_us > copy.max_latency)
+    {
+        stats->p99_us = copy.max_latency;
+    }
+    stats->p99_us /= cycles_per_us;
+}
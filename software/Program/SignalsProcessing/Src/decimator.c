@@ -0,0 +1,235 @@
+/**
+ * @file decimator.c
+ * @brief Implementation file for the CIC and polyphase FIR decimator of the acquisition front-end.
+ *
+ * This file contains the design of the compensating FIR filter and the
+ * decimation of the raw samples. The filter is designed once at startup by
+ * sampling the desired response, the inverse CIC response in the passband
+ * with a raised cosine transition to the stopband, and weighting the
+ * resulting impulse response with a Blackman window. The coefficients are
+ * rounded to Q15 with a DC gain of exactly one, so a constant input gives
+ * exactly the input code shifted by DEC_EXTRA_BITS.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <string.h>
+#include <math.h>
+#include "arm_math.h"
+#include "decimator.h"
+
+/** @brief Right shift that removes the CIC and FIR gains and keeps DEC_EXTRA_BITS. */
+#define DEC_OUTPUT_SHIFT                   ( DEC_CIC_GAIN_BITS + DEC_COEFF_FRAC_BITS - DEC_EXTRA_BITS )
+
+/** @brief Global decimator of the acquisition front-end. */
+DEC_Handle_t dec_handle = {0};
+
+
+/**
+ * @brief Returns the magnitude response of the CIC filter, normalized to a DC gain of one.
+ *
+ * @param nu Frequency relative to the CIC output rate.
+ * @return float32_t Magnitude response.
+ */
+static float32_t dec_cic_response(float32_t nu)
+{
+    float32_t response = 1.0f;
+
+    if( (nu > 0.0f) && (DEC_CIC_RATIO > 1) )
+    {
+        response = sinf(PI * nu) / ( (float32_t)DEC_CIC_RATIO * sinf(PI * nu / (float32_t)DEC_CIC_RATIO) );
+    }
+
+    return powf(fabsf(response), (float32_t)DEC_CIC_ORDER);
+}
+
+
+/**
+ * @brief Returns the desired response of the FIR filter.
+ *
+ * @param nu Frequency relative to the FIR input rate, twice the output rate.
+ * @return float32_t Desired magnitude response.
+ */
+static float32_t dec_desired_response(float32_t nu)
+{
+    float32_t pass = DEC_PASS_EDGE / 2.0f;
+    float32_t stop = DEC_STOP_EDGE / 2.0f;
+
+    if (nu <= pass)
+    {
+        return 1.0f / dec_cic_response(nu);
+    }
+
+    if (nu < stop)
+    {
+        return 0.5f * ( 1.0f + cosf(PI * (nu - pass) / (stop - pass)) ) / dec_cic_response(nu);
+    }
+
+    return 0.0f;
+}
+
+
+/**
+ * @brief Designs the Q15 FIR coefficients.
+ *
+ * @param taps Pointer to the DEC_FIR_LEN coefficients to be filled.
+ */
+static void dec_design(int16_t *const taps)
+{
+    float32_t h[DEC_FIR_LEN];
+    float32_t center = (float32_t)(DEC_FIR_LEN - 1) / 2.0f;
+    float32_t sum = 0.0f;
+    int32_t total = 0;
+
+    for(size_t n = 0; n < DEC_FIR_LEN; n++)
+    {
+        float32_t acc = 0.0f;
+
+        /* Inverse transform of the sampled desired response, the end points count half */
+        for(size_t k = 0; k < DEC_DESIGN_POINTS; k++)
+        {
+            float32_t nu = 0.5f * (float32_t)k / (float32_t)(DEC_DESIGN_POINTS - 1);
+            float32_t weight = ( (k == 0) || (k == DEC_DESIGN_POINTS - 1) ) ? 0.5f : 1.0f;
+
+            acc += weight * dec_desired_response(nu) * cosf(2.0f * PI * nu * ((float32_t)n - center));
+        }
+
+        /* Blackman window */
+        h[n] = acc * ( 0.42f - 0.5f * cosf(2.0f * PI * (float32_t)n / (float32_t)(DEC_FIR_LEN - 1))
+                             + 0.08f * cosf(4.0f * PI * (float32_t)n / (float32_t)(DEC_FIR_LEN - 1)) );
+        sum += h[n];
+    }
+
+    /* Unity DC gain, the rounding error goes to the two center taps */
+    for(size_t n = 0; n < DEC_FIR_LEN; n++)
+    {
+        taps[n] = (int16_t)lroundf(h[n] / sum * (float32_t)(1 << DEC_COEFF_FRAC_BITS));
+        total += taps[n];
+    }
+
+    total = (1 << DEC_COEFF_FRAC_BITS) - total;
+    taps[DEC_FIR_LEN / 2 - 1] += (int16_t)(total / 2);
+    taps[DEC_FIR_LEN / 2] += (int16_t)(total - total / 2);
+}
+
+
+/**
+ * @brief Designs the FIR filter and clears the filter state.
+ *
+ * Must be called before the first block is decimated.
+ *
+ * @param handle Pointer to the DEC_Handle_t structure.
+ */
+void dec_init(DEC_Handle_t *const handle)
+{
+    memset(handle, 0, sizeof(DEC_Handle_t));
+    dec_design(handle->taps);
+
+    /* Output p combines h[2i] with sample 2p + 1 - 2i and h[2i + 1] with sample 2p - 2i */
+    for(size_t i = 0; i < DEC_PHASE_LEN; i++)
+    {
+        handle->odd_taps[i] = handle->taps[2 * i];
+        handle->even_taps[i] = handle->taps[2 * i + 1];
+    }
+}
+
+
+/**
+ * @brief Converts an accumulated FIR output to an output code.
+ *
+ * @param acc FIR output in units of the CIC output times 2^DEC_COEFF_FRAC_BITS.
+ * @return uint32_t Output code, rounded and limited to 0..DEC_OUTPUT_MAX.
+ */
+static inline uint32_t dec_output(int64_t acc)
+{
+    int32_t code = (int32_t)( ( acc + ( (int64_t)1 << (DEC_OUTPUT_SHIFT - 1) ) ) >> DEC_OUTPUT_SHIFT );
+
+    return (code < 0) ? 0 : ( (code > DEC_OUTPUT_MAX) ? DEC_OUTPUT_MAX : (uint32_t)code );
+}
+
+
+/**
+ * @brief Runs the CIC filter of one channel over DEC_CIC_RATIO raw samples.
+ *
+ * @param channel Pointer to the DEC_Channel_t structure.
+ * @param src First raw sample.
+ * @param shift 0 for ADC1 (low half-word), 16 for ADC2 (high half-word).
+ * @return int32_t CIC output for the last of the samples.
+ */
+static inline int32_t dec_cic(DEC_Channel_t *const channel, const uint32_t *src, uint32_t shift)
+{
+    uint32_t value = 0;
+
+    for(size_t r = 0; r < DEC_CIC_RATIO; r++)
+    {
+        value = (src[r] >> shift) & 0xFFFFU;
+
+        for(size_t s = 0; s < DEC_CIC_ORDER; s++)
+        {
+            channel->integrator[s] += value;
+            value = channel->integrator[s];
+        }
+    }
+
+    for(size_t s = 0; s < DEC_CIC_ORDER; s++)
+    {
+        uint32_t previous = channel->comb[s];
+
+        channel->comb[s] = value;
+        value -= previous;
+    }
+
+    return (int32_t)value;
+}
+
+
+/**
+ * @brief Decimates a block of raw dual ADC samples.
+ *
+ * For every output sample the CIC filter produces two intermediate samples,
+ * one for each polyphase branch, and the FIR filter is evaluated once. The
+ * filter state carries over from one block to the next, so consecutive
+ * blocks give the same output as one long block.
+ *
+ * @param handle Pointer to the DEC_Handle_t structure.
+ * @param src Raw samples, ADC1 in the low and ADC2 in the high half-word.
+ * @param dst Output samples in the same format, len / SIG_DECIMATION words.
+ * @param len Number of raw samples, a multiple of SIG_DECIMATION.
+ */
+void dec_process(DEC_Handle_t *const handle, const uint32_t *src, uint32_t *dst, size_t len)
+{
+    uint32_t index = handle->line_index;
+
+    for(size_t i = 0; i < len; i += SIG_DECIMATION)
+    {
+        uint32_t out = 0;
+
+        index = (index == 0) ? (DEC_PHASE_LEN - 1) : (index - 1);
+
+        for(uint32_t c = 0; c < 2; c++)
+        {
+            DEC_Channel_t *channel = &handle->channel[c];
+            int32_t even = dec_cic(channel, &src[i], 16 * c);
+            int32_t odd = dec_cic(channel, &src[i + DEC_CIC_RATIO], 16 * c);
+            const int32_t *even_line = &channel->even_line[index];
+            const int32_t *odd_line = &channel->odd_line[index];
+            int64_t acc = 0;
+
+            channel->even_line[index] = channel->even_line[index + DEC_PHASE_LEN] = even;
+            channel->odd_line[index] = channel->odd_line[index + DEC_PHASE_LEN] = odd;
+
+            for(size_t k = 0; k < DEC_PHASE_LEN; k++)
+            {
+                acc += (int64_t)handle->odd_taps[k] * odd_line[k] + (int64_t)handle->even_taps[k] * even_line[k];
+            }
+
+            out |= dec_output(acc) << (16 * c);
+        }
+
+        dst[i / SIG_DECIMATION] = out;
+    }
+
+    handle->line_index = (uint8_t)index;
+}
+
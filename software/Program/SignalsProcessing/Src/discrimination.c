@@ -0,0 +1,157 @@
+/**
+ * @file discrimination.c
+ * @brief Implementation file for the target discrimination.
+ *
+ * This file contains the phase ranges of the target classes, the preset
+ * masks and the constant-time lookups. The phase ranges are given in the
+ * signed convention of md_phase_difference(); with the unsigned convention
+ * only the ranges from 0 to 180 degrees are reached. They depend on the coil
+ * and the TX frequency and are set in ds_ranges[].
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <stddef.h>
+#include "discrimination.h"
+
+/** @brief Phase ranges of the classes in ascending order, the last one ends at 179 degrees. */
+static const DS_Range_t ds_ranges[] =
+{
+    {  -1, DS_CLASS_FERROUS },
+    {  14, DS_CLASS_FOIL },
+    {  39, DS_CLASS_LOW },
+    {  64, DS_CLASS_MID },
+    {  89, DS_CLASS_HIGH },
+    { 179, DS_CLASS_FERROUS },
+};
+
+/** @brief Global handle for the discrimination, the masks are valid before ds_init(). */
+DS_Handle_t ds_handle =
+{
+    .masks =
+    {
+        [DS_PRESET_ALL_METAL]  = (1UL << DS_CLASS_COUNT) - 1,
+        [DS_PRESET_NO_FERROUS] = ( (1UL << DS_CLASS_COUNT) - 1 ) & ~(1UL << DS_CLASS_FERROUS),
+        [DS_PRESET_COINS]      = (1UL << DS_CLASS_MID) | (1UL << DS_CLASS_HIGH),
+        [DS_PRESET_CUSTOM]     = (1UL << DS_CLASS_COUNT) - 1,
+    },
+    .preset = DS_PRESET_ALL_METAL,
+};
+
+/** @brief Short name of every class. */
+const char *const ds_class_names[DS_CLASS_COUNT] = { "Fe", "Fo", "Lo", "Mi", "Hi" };
+
+/** @brief Short name of every preset. */
+const char *const ds_preset_names[DS_PRESET_COUNT] = { "All", "NoFe", "Coin", "Cust" };
+
+
+/**
+ * @brief Builds the phase table, the presets keep their masks.
+ *
+ * @param handle Pointer to the DS_Handle_t structure.
+ */
+void ds_init(DS_Handle_t *const handle)
+{
+    size_t range = 0;
+
+    for(size_t i = 0; i < DS_TABLE_LEN; i++)
+    {
+        int16_t phase = (int16_t)i - (DS_TABLE_LEN / 2);
+
+        while( (phase > ds_ranges[range].upper) && (range < (sizeof(ds_ranges) / sizeof(ds_ranges[0])) - 1) )
+        {
+            range++;
+        }
+
+        handle->classes[i] = (uint8_t) ds_ranges[range].target_class;
+    }
+}
+
+
+/**
+ * @brief Returns the class of a phase difference.
+ *
+ * A phase difference of 180 degrees is the same as -180 degrees, so it is
+ * wrapped onto the first table entry.
+ *
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param phase_difference Phase difference in degrees, as reported by md_detect().
+ * @return DS_Class_t Class of the phase difference.
+ */
+DS_Class_t ds_classify(const DS_Handle_t *const handle, int16_t phase_difference)
+{
+    int32_t index = (int32_t)phase_difference + (DS_TABLE_LEN / 2);
+
+    if (index >= DS_TABLE_LEN)
+    {
+        index -= DS_TABLE_LEN;
+    }
+    else if (index < 0)
+    {
+        index += DS_TABLE_LEN;
+    }
+
+    return (DS_Class_t) handle->classes[index];
+}
+
+
+/**
+ * @brief Returns whether a class is accepted by the active preset.
+ *
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param target_class Class of the target.
+ * @return uint8_t 1 if the class is accepted, 0 if it is notched out.
+ */
+uint8_t ds_accept(const DS_Handle_t *const handle, DS_Class_t target_class)
+{
+    return (uint8_t)( (handle->masks[handle->preset] >> target_class) & 1UL );
+}
+
+
+/**
+ * @brief Selects the active preset.
+ *
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param preset Preset to be used from the next detection on.
+ */
+void ds_set_preset(DS_Handle_t *const handle, DS_Preset_t preset)
+{
+    if (preset < DS_PRESET_COUNT)
+    {
+        handle->preset = preset;
+    }
+}
+
+
+/**
+ * @brief Accepts or notches out one class in the custom preset and selects it.
+ *
+ * Editing another preset starts the custom preset from its mask, so a notch
+ * can be added to a preset without changing the preset itself.
+ *
+ * @param handle Pointer to the DS_Handle_t structure.
+ * @param target_class Class to be changed.
+ * @param accept 1 to accept the class, 0 to notch it out.
+ */
+void ds_set_notch(DS_Handle_t *const handle, DS_Class_t target_class, uint8_t accept)
+{
+    uint32_t mask = handle->masks[handle->preset];
+
+    if (target_class >= DS_CLASS_COUNT)
+    {
+        return;
+    }
+
+    if (accept)
+    {
+        mask |= (1UL << target_class);
+    }
+    else
+    {
+        mask &= ~(1UL << target_class);
+    }
+
+    handle->masks[DS_PRESET_CUSTOM] = mask;
+    handle->preset = DS_PRESET_CUSTOM;
+}
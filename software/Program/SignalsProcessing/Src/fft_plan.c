@@ -0,0 +1,172 @@
+/**
+ * @file fft_plan.c
+ * @brief Implementation file for the FFT plan cache.
+ *
+ * This file contains the implementation of the cache of real and complex FFT
+ * instances. The instances only hold pointers to the constant twiddle and bit
+ * reversal tables, so one instance per length can be shared by the RX and TX
+ * channels. The complex instances are taken from the internal complex FFT of a
+ * real FFT of twice the length, which is the only way this version of the
+ * CMSIS DSP library exposes them.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include "cycle_counter.h"
+#include "fft_plan.h"
+
+/** @brief Global FFT plan cache. */
+FFT_PlanCache_t fft_plan_cache = {0};
+
+/** @brief Result of the last fft_plan_benchmark() call. */
+FFT_PlanBenchmark_t fft_plan_benchmark_result = {0};
+
+
+/**
+ * @brief Initializes the FFT instances for all supported transform lengths.
+ *
+ * This function is called once at startup. Afterwards the instances are
+ * only read, so they can be used by any task without further initialization.
+ *
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ */
+void fft_plan_init(FFT_PlanCache_t *const cache)
+{
+    arm_rfft_fast_instance_f32 double_len_rfft = {0};
+
+    for(size_t i = 0; i < FFT_PLAN_COUNT; i++)
+    {
+        arm_rfft_fast_init_f32(&cache->rfft[i], (uint16_t)(FFT_PLAN_MIN_LEN << i));
+
+        /* A real FFT of length 2N runs a complex FFT of length N internally */
+        arm_rfft_fast_init_f32(&double_len_rfft, (uint16_t)(FFT_PLAN_MIN_LEN << (i + 1)));
+        cache->cfft[i] = double_len_rfft.Sint;
+
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+        arm_rfft_init_q15(&cache->rfft_q15[i], FFT_PLAN_MIN_LEN << i, 0, 1);
+#endif
+    }
+}
+
+
+/**
+ * @brief Converts a supported transform length to the index of its instances.
+ *
+ * @param fft_len Transform length.
+ * @param index Pointer to the variable that receives the index.
+ * @return uint8_t 1 if the length is supported, 0 otherwise.
+ */
+static uint8_t fft_plan_index(uint16_t fft_len, size_t *const index)
+{
+    /* Only powers of two within the cached range are supported */
+    if( (fft_len < FFT_PLAN_MIN_LEN) || (fft_len > FFT_PLAN_MAX_LEN) || ((fft_len & (fft_len - 1)) != 0) )
+    {
+        return 0;
+    }
+
+    *index = 0;
+    while( (FFT_PLAN_MIN_LEN << *index) != fft_len )
+    {
+        (*index)++;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Returns the cached real FFT instance for the given transform length.
+ *
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Transform length, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const arm_rfft_fast_instance_f32* Cached instance, or NULL if the length is not supported.
+ */
+const arm_rfft_fast_instance_f32 *fft_plan_get(const FFT_PlanCache_t *const cache, uint16_t fft_len)
+{
+    size_t index = 0;
+
+    if( fft_plan_index(fft_len, &index) == 0 )
+    {
+        return NULL;
+    }
+
+    return &cache->rfft[index];
+}
+
+
+/**
+ * @brief Returns the cached complex FFT instance for the given transform length.
+ *
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Number of complex points, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const arm_cfft_instance_f32* Cached instance, or NULL if the length is not supported.
+ */
+const arm_cfft_instance_f32 *fft_plan_get_cfft(const FFT_PlanCache_t *const cache, uint16_t fft_len)
+{
+    size_t index = 0;
+
+    if( fft_plan_index(fft_len, &index) == 0 )
+    {
+        return NULL;
+    }
+
+    return &cache->cfft[index];
+}
+
+
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_Q15
+/**
+ * @brief Returns the cached Q15 real FFT instance for the given transform length.
+ *
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Transform length, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const arm_rfft_instance_q15* Cached instance, or NULL if the length is not supported.
+ */
+const arm_rfft_instance_q15 *fft_plan_get_q15(const FFT_PlanCache_t *const cache, uint16_t fft_len)
+{
+    size_t index = 0;
+
+    if( fft_plan_index(fft_len, &index) == 0 )
+    {
+        return NULL;
+    }
+
+    return &cache->rfft_q15[index];
+}
+#endif
+
+
+/**
+ * @brief Measures the per-frame cost of creating the FFT instances against looking them up.
+ *
+ * This function repeats what sig_perform_fft() used to do on every block, two
+ * arm_rfft_fast_init_f32() calls, and compares it with two cache lookups.
+ * The difference is the number of cycles saved per frame. The cycle counter
+ * must be enabled with cc_init() beforehand.
+ *
+ * @param cache Pointer to the FFT_PlanCache_t structure.
+ * @param fft_len Transform length used for the measurement.
+ * @param result Pointer to the FFT_PlanBenchmark_t structure that receives the cycle counts.
+ */
+void fft_plan_benchmark(const FFT_PlanCache_t *const cache, uint16_t fft_len, FFT_PlanBenchmark_t *const result)
+{
+    arm_rfft_fast_instance_f32 rx_fft_instance = {0};
+    arm_rfft_fast_instance_f32 tx_fft_instance = {0};
+    const arm_rfft_fast_instance_f32 *volatile plan = NULL;
+    uint32_t start = 0;
+
+    /* Per-frame initialization of both instances */
+    start = cc_get();
+    arm_rfft_fast_init_f32(&rx_fft_instance, fft_len);
+    arm_rfft_fast_init_f32(&tx_fft_instance, fft_len);
+    result->init_cycles = cc_get() - start;
+
+    /* Lookup of the shared instance for both channels */
+    start = cc_get();
+    plan = fft_plan_get(cache, fft_len);
+    plan = fft_plan_get(cache, fft_len);
+    result->lookup_cycles = cc_get() - start;
+
+    (void) plan;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file frame_ring.c
+ * @brief Implementation file for the lock-free ring of ADC frame descriptors.
+ *
+ * This file contains the implementation of the frame descriptor ring. The
+ * producer fills the slot before it publishes the new write index, and the
+ * consumer copies the slot before it publishes the new read index. A data
+ * memory barrier keeps each pair of accesses in order, so no lock and no
+ * critical section is needed between the ADC interrupts and the task.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <string.h>
+#include "arm_math.h"
+#include "frame_ring.h"
+
+
+/**
+ * @brief Empties the ring and clears its counters.
+ *
+ * Must be called before the producer is started.
+ *
+ * @param ring Pointer to the FR_Ring_t structure.
+ */
+void fr_init(FR_Ring_t *const ring)
+{
+    memset(ring, 0, sizeof(FR_Ring_t));
+}
+
+
+/**
+ * @brief Appends a descriptor, to be called by the producer only.
+ *
+ * A full ring keeps its oldest descriptors, so the consumer still sees
+ * consecutive frames, and the dropped frame is counted.
+ *
+ * @param ring Pointer to the FR_Ring_t structure.
+ * @param frame Pointer to the descriptor to be copied into the ring.
+ * @return FR_Status_t FR_OK if the descriptor was queued, FR_FULL if it was dropped.
+ */
+FR_Status_t fr_push(FR_Ring_t *const ring, const FR_Descriptor_t *const frame)
+{
+    uint32_t write_index = ring->write_index;
+
+    if ( (write_index - ring->read_index) >= FR_RING_LEN )
+    {
+        ring->drops++;
+        return FR_FULL;
+    }
+
+    ring->slots[write_index & (FR_RING_LEN - 1)] = *frame;
+
+    /* The slot must be complete before the consumer can see it */
+    __DMB();
+    ring->write_index = write_index + 1;
+
+    return FR_OK;
+}
+
+
+/**
+ * @brief Removes the oldest descriptor, to be called by the consumer only.
+ *
+ * This function also tracks the largest number of waiting descriptors and the
+ * number of frames missing between consecutive sequence numbers, which covers
+ * frames dropped by the ring as well as frames never pushed.
+ *
+ * @param ring Pointer to the FR_Ring_t structure.
+ * @param frame Pointer to the FR_Descriptor_t structure that receives the descriptor.
+ * @return FR_Status_t FR_OK if a descriptor was returned, FR_EMPTY otherwise.
+ */
+FR_Status_t fr_pop(FR_Ring_t *const ring, FR_Descriptor_t *const frame)
+{
+    uint32_t read_index = ring->read_index;
+    uint32_t depth = ring->write_index - read_index;
+
+    if (depth == 0)
+    {
+        return FR_EMPTY;
+    }
+
+    if (depth > ring->max_depth)
+    {
+        ring->max_depth = depth;
+    }
+
+    /* Read the slot only after the write index that published it */
+    __DMB();
+    *frame = ring->slots[read_index & (FR_RING_LEN - 1)];
+
+    /* The slot must be copied before the producer can reuse it */
+    __DMB();
+    ring->read_index = read_index + 1;
+
+    if ( (ring->last_sequence != 0) && (frame->sequence != ring->last_sequence + 1) )
+    {
+        ring->gaps += frame->sequence - ring->last_sequence - 1;
+    }
+    ring->last_sequence = frame->sequence;
+
+    return FR_OK;
+}
+
+
+/**
+ * @brief Returns the number of descriptors waiting in the ring.
+ *
+ * @param ring Pointer to the FR_Ring_t structure.
+ * @return uint32_t Number of queued descriptors.
+ */
+uint32_t fr_depth(const FR_Ring_t *const ring)
+{
+    return ring->write_index - ring->read_index;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file freq_plan.c
+ * @brief Implementation file for the coherent sampling frequency plan.
+ *
+ * This file checks the frequency plan at compile time and generates the DAC
+ * tables from it. The multi-tone table uses Schroeder phases, which keep the
+ * peaks of the summed tones apart and so bound the crest factor. The tables are computed once at startup instead of being
+ * stored as constants, so they always match the planned lengths.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include "app_signal.h"
+#include "freq_plan.h"
+
+#if ( FP_TX_TABLE_LEN & ( FP_TX_TABLE_LEN - 1 ) ) != 0
+#error "FP_TX_TABLE_LEN must be a power of two"
+#endif
+
+#if ( FP_BLOCK_LEN % FP_TX_TABLE_LEN ) != 0
+#error "FP_BLOCK_LEN must hold whole TX periods"
+#endif
+
+#if ( FFT_PLAN_MIN_LEN % FP_TX_TABLE_LEN ) != 0
+#error "Every supported FFT length must hold whole TX periods"
+#endif
+
+#if ( ( FP_MT_TABLE_LEN & ( FP_MT_TABLE_LEN - 1 ) ) != 0 ) || ( ( FP_BLOCK_LEN % FP_MT_TABLE_LEN ) != 0 ) || ( ( FP_MT_TABLE_LEN % FP_TX_TABLE_LEN ) != 0 )
+#error "FP_MT_TABLE_LEN must be a power of two between FP_TX_TABLE_LEN and FP_BLOCK_LEN"
+#endif
+
+#if ( FP_TIM_PERIOD < 2 ) || ( FP_AUDIO_TABLE_LEN < 2 )
+#error "The frequency targets cannot be reached with the timer clock"
+#endif
+
+#if ( FP_DAC_MID_SCALE + FP_TX_AMPLITUDE > FP_DAC_MAX_VALUE ) || ( FP_DAC_MID_SCALE + FP_AUDIO_AMPLITUDE > FP_DAC_MAX_VALUE ) || \
+    ( FP_DAC_MID_SCALE + FP_MT_PEAK_AMPLITUDE > FP_DAC_MAX_VALUE )
+#error "The generated signals exceed the DAC range"
+#endif
+
+
+/**
+ * @brief Fills a table with one period of a sine wave in DAC codes.
+ *
+ * The sine is centered at FP_DAC_MID_SCALE and starts at phase 0.
+ *
+ * @param table Pointer to the table to be filled.
+ * @param len Number of entries in the table.
+ * @param amplitude Amplitude in DAC codes.
+ */
+void fp_generate_sine(uint32_t *const table, size_t len, uint32_t amplitude)
+{
+    for(size_t i = 0; i < len; i++)
+    {
+        float32_t angle = 2.0f * PI * (float32_t)i / (float32_t)len;
+
+        table[i] = (uint32_t)( (int32_t)FP_DAC_MID_SCALE + (int32_t)lroundf((float32_t)amplitude * sinf(angle)) );
+    }
+}
+
+
+/**
+ * @brief Computes one sample of the unscaled multi-tone signal.
+ *
+ * Tone k (counted from 0) gets the Schroeder phase -pi * k * (k + 1) / count.
+ *
+ * @param i Sample index within the table period.
+ * @param len Number of entries in the table.
+ * @param cycles Cycles of each tone per table period.
+ * @param count Number of tones.
+ * @return float32_t Sum of the unit-amplitude tones.
+ */
+static float32_t fp_multitone_sample(size_t i, size_t len, const uint8_t *const cycles, size_t count)
+{
+    float32_t sum = 0;
+
+    for(size_t k = 0; k < count; k++)
+    {
+        float32_t phase = -PI * (float32_t)(k * (k + 1)) / (float32_t)count;
+        float32_t angle = 2.0f * PI * (float32_t)(cycles[k] * i % len) / (float32_t)len;
+
+        sum += sinf(angle + phase);
+    }
+
+    return sum;
+}
+
+
+/**
+ * @brief Fills a table with one period of the sum of several equal-amplitude tones in DAC codes.
+ *
+ * The sum is scaled so that its largest sample reaches the requested peak
+ * amplitude, so the table never exceeds the DAC range whatever the tones are.
+ * The returned crest factor tells how much amplitude each tone gets compared
+ * with a single tone of the same peak.
+ *
+ * @param table Pointer to the table to be filled.
+ * @param len Number of entries in the table.
+ * @param cycles Cycles of each tone per table period.
+ * @param count Number of tones.
+ * @param peak_amplitude Peak amplitude of the sum in DAC codes.
+ * @return float Crest factor (peak / RMS) of the generated signal.
+ */
+float fp_generate_multitone(uint32_t *const table, size_t len, const uint8_t *const cycles, size_t count, uint32_t peak_amplitude)
+{
+    float32_t peak = 0, power = 0, scale = 0;
+
+    /* Find the peak and the power of the unscaled sum */
+    for(size_t i = 0; i < len; i++)
+    {
+        float32_t sample = fp_multitone_sample(i, len, cycles, count);
+
+        peak = fmaxf(peak, fabsf(sample));
+        power += sample * sample;
+    }
+
+    scale = (float32_t)peak_amplitude / peak;
+
+    for(size_t i = 0; i < len; i++)
+    {
+        table[i] = (uint32_t)( (int32_t)FP_DAC_MID_SCALE + (int32_t)lroundf(scale * fp_multitone_sample(i, len, cycles, count)) );
+    }
+
+    return peak / sqrtf(power / (float32_t)len);
+}
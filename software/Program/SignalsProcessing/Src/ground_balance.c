@@ -0,0 +1,262 @@
+/**
+ * @file ground_balance.c
+ * @brief Implementation file for the automatic ground balance.
+ *
+ * This file contains the capture of the ground direction and its removal.
+ * Pumping the coil moves the ground response along a line in the complex
+ * plane, whose direction is the ground phase. It is found as the principal
+ * axis of the captured vectors, i.e. half the angle of the complex
+ * covariance. If the pumping was too weak to give a direction, the direction
+ * of the average vector is taken instead.
+ *
+ * Removing the ground replaces the RX magnitude by the magnitude of the
+ * component of the cross spectrum that is perpendicular to the ground
+ * direction, which is one real dot product and one division. The cross
+ * spectrum itself is left as it is, as its angle is the phase of the target
+ * that the discrimination and the display need, and the ground direction is
+ * passed on in the result for the motion detector.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include <string.h>
+#include "ground_balance.h"
+#include "fast_math.h"
+
+/** @brief Global handle for the ground balance. */
+GB_Handle_t gb_handle = {0};
+
+
+/**
+ * @brief Adds a vector to the capture sums of one tone.
+ *
+ * @param channel Pointer to the GB_Channel_t structure of the tone.
+ * @param first 1 for the first result of the capture.
+ * @param cross_real Real part of the cross spectrum RX * conj(TX).
+ * @param cross_imag Imaginary part of the cross spectrum RX * conj(TX).
+ * @param tx_magnitude TX magnitude of the result.
+ */
+static void gb_capture(GB_Channel_t *const channel, uint8_t first, float32_t cross_real, float32_t cross_imag,
+                       float32_t tx_magnitude)
+{
+    float32_t real = 0, imag = 0;
+
+    if (tx_magnitude <= 0.0f)
+    {
+        return;
+    }
+
+    /* The RX vector referenced to the TX phase does not change with the TX amplitude */
+    real = cross_real / tx_magnitude;
+    imag = cross_imag / tx_magnitude;
+
+    if (first)
+    {
+        channel->origin_real = real;
+        channel->origin_imag = imag;
+        channel->sum_real = 0;
+        channel->sum_imag = 0;
+        channel->sum_real_real = 0;
+        channel->sum_imag_imag = 0;
+        channel->sum_real_imag = 0;
+    }
+
+    real -= channel->origin_real;
+    imag -= channel->origin_imag;
+
+    channel->sum_real += real;
+    channel->sum_imag += imag;
+    channel->sum_real_real += real * real;
+    channel->sum_imag_imag += imag * imag;
+    channel->sum_real_imag += real * imag;
+}
+
+
+/**
+ * @brief Sets the ground direction of one tone from its capture sums.
+ *
+ * @param channel Pointer to the GB_Channel_t structure of the tone.
+ * @param count Number of captured results.
+ */
+static void gb_finish(GB_Channel_t *const channel, uint32_t count)
+{
+    const float32_t n = (float32_t)count;
+    float32_t mean_real = channel->sum_real / n;
+    float32_t mean_imag = channel->sum_imag / n;
+    float32_t var_real = channel->sum_real_real / n - mean_real * mean_real;
+    float32_t var_imag = channel->sum_imag_imag / n - mean_imag * mean_imag;
+    float32_t covar = channel->sum_real_imag / n - mean_real * mean_imag;
+    float32_t angle = 0;
+
+    if (var_real + var_imag >= GB_MIN_SPREAD * GB_MIN_SPREAD)
+    {
+        /* Principal axis of the pumping */
+        angle = 0.5f * fm_atan2f(2.0f * covar, var_real - var_imag);
+    }
+    else
+    {
+        /* Direction of the ground response itself */
+        angle = fm_atan2f(channel->origin_imag + mean_imag, channel->origin_real + mean_real);
+    }
+
+    channel->ground_real = cosf(angle);
+    channel->ground_imag = sinf(angle);
+
+    /* The axis has no sign, keep it in the right half-plane */
+    if (channel->ground_real < 0.0f)
+    {
+        channel->ground_real = -channel->ground_real;
+        channel->ground_imag = -channel->ground_imag;
+    }
+}
+
+
+/**
+ * @brief Removes the ground component from the RX magnitude of one tone.
+ *
+ * @param channel Pointer to the GB_Channel_t structure of the tone.
+ * @param magnitude Pointer to the RX magnitude, replaced by the one without the ground.
+ * @param cross_real Real part of the cross spectrum RX * conj(TX).
+ * @param cross_imag Imaginary part of the cross spectrum RX * conj(TX).
+ * @param tx_magnitude TX magnitude of the result.
+ */
+static void gb_remove(const GB_Channel_t *const channel, float32_t *const magnitude, float32_t cross_real,
+                      float32_t cross_imag, float32_t tx_magnitude)
+{
+    /* Component perpendicular to the ground, i.e. the imaginary part of cross * conj(ground) */
+    float32_t perpendicular = cross_imag * channel->ground_real - cross_real * channel->ground_imag;
+
+    *magnitude = (tx_magnitude > 0.0f) ? fabsf(perpendicular) / tx_magnitude : 0.0f;
+}
+
+
+/**
+ * @brief Initializes the ground balance without a balance.
+ *
+ * @param handle Pointer to the GB_Handle_t structure.
+ * @param update_period_ms Time between two results in milliseconds.
+ */
+void gb_init(GB_Handle_t *const handle, float32_t update_period_ms)
+{
+    memset(handle->channel, 0, sizeof(handle->channel));
+
+    handle->capture_frames = (uint32_t) ceilf(GB_CAPTURE_MS / update_period_ms);
+    handle->captured = 0;
+    handle->served = handle->requests;
+    handle->capture_tones = 0;
+    handle->balanced_tones = 0;
+    handle->grounded = 0;
+    handle->ground_phase = 0;
+    handle->state = GB_OFF;
+}
+
+
+/**
+ * @brief Requests a new ground capture, returns immediately.
+ *
+ * The capture starts with the next result of the signal processing task. A
+ * request during a running capture restarts it.
+ *
+ * @param handle Pointer to the GB_Handle_t structure.
+ */
+void gb_start(GB_Handle_t *const handle)
+{
+    handle->requests++;
+}
+
+
+/**
+ * @brief Returns the progress of the running capture.
+ *
+ * @param handle Pointer to the GB_Handle_t structure.
+ * @return uint8_t Progress in percent, 0 if no capture runs.
+ */
+uint8_t gb_progress(const GB_Handle_t *const handle)
+{
+    if ( (handle->state != GB_CAPTURING) || (handle->capture_frames == 0) )
+    {
+        return 0;
+    }
+
+    return (uint8_t)( (100UL * handle->captured) / handle->capture_frames );
+}
+
+
+/**
+ * @brief Captures a result if requested and removes the ground component from its magnitudes.
+ *
+ * The result is captured before the removal, so the capture sees the ground
+ * itself even if an older balance is in effect. In multi-tone mode every
+ * tone is balanced with its own ground direction, and only the tones that
+ * were present during the capture are balanced.
+ *
+ * @param handle Pointer to the GB_Handle_t structure.
+ * @param data Pointer to the MD_Data_t structure of the result, its magnitudes and ground direction are overwritten.
+ * @return uint8_t 1 if a new ground balance took effect with this result, 0 otherwise.
+ */
+uint8_t gb_update(GB_Handle_t *const handle, MD_Data_t *const data)
+{
+    uint32_t requests = handle->requests;
+    uint8_t balanced = 0;
+
+    if (requests != handle->served)
+    {
+        handle->served = requests;
+        handle->captured = 0;
+        handle->capture_tones = (data->tone_count < MD_MAX_TONES) ? data->tone_count : MD_MAX_TONES;
+        handle->state = GB_CAPTURING;
+    }
+
+    if (handle->state == GB_CAPTURING)
+    {
+        uint8_t first = (handle->captured == 0) ? 1 : 0;
+
+        gb_capture(&handle->channel[0], first, data->cross_real, data->cross_imag, data->tx_signal_magnitude);
+        for(size_t t = 0; (t < data->tone_count) && (t < handle->capture_tones); t++)
+        {
+            gb_capture(&handle->channel[t + 1], first, data->tones[t].cross_real, data->tones[t].cross_imag,
+                       data->tones[t].tx_signal_magnitude);
+        }
+
+        if (++handle->captured >= handle->capture_frames)
+        {
+            for(size_t c = 0; c < (size_t)handle->capture_tones + 1; c++)
+            {
+                gb_finish(&handle->channel[c], handle->captured);
+            }
+            handle->balanced_tones = handle->capture_tones;
+
+            handle->ground_phase = (int16_t) md_phase_difference(handle->channel[0].ground_real,
+                                                                 handle->channel[0].ground_imag, MD_PHASE_SIGNED);
+            handle->grounded = 1;
+            handle->state = GB_BALANCED;
+            balanced = 1;
+        }
+    }
+
+    /* A capture in progress keeps the previous balance, if any */
+    if (handle->grounded)
+    {
+        gb_remove(&handle->channel[0], &data->rx_signal_magnitude, data->cross_real, data->cross_imag,
+                  data->tx_signal_magnitude);
+        for(size_t t = 0; (t < data->tone_count) && (t < handle->balanced_tones); t++)
+        {
+            MD_ToneData_t *tone = &data->tones[t];
+
+            gb_remove(&handle->channel[t + 1], &tone->rx_signal_magnitude, tone->cross_real, tone->cross_imag,
+                      tone->tx_signal_magnitude);
+        }
+
+        data->ground_real = handle->channel[0].ground_real;
+        data->ground_imag = handle->channel[0].ground_imag;
+    }
+    else
+    {
+        data->ground_real = 0;
+        data->ground_imag = 0;
+    }
+
+    return balanced;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file iq_demod.c
+ * @brief Implementation file for the single-bin synchronous I/Q demodulator.
+ *
+ * This file contains the implementation of the I/Q demodulation engine.
+ * The TX signal period is exactly FP_TX_TABLE_LEN samples because the
+ * DAC and both ADCs are triggered by the same timer, so one period of reference
+ * values is enough to demodulate any number of samples. The sum is taken over
+ * whole TX periods only, which cancels the DC offset of the ADC codes and
+ * keeps the other frequencies from leaking into the result.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include "cycle_counter.h"
+#include "iq_demod.h"
+
+#if IQ_TONE_COUNT > MD_MAX_TONES
+#error "MD_Data_t cannot hold all multi-tone tones"
+#endif
+
+/** @brief Global handle for the I/Q demodulator. */
+IQ_Handle_t iq_handle = {0};
+
+/** @brief Result of the last iq_benchmark() call. */
+IQ_Benchmark_t iq_benchmark_result = {0};
+
+
+/**
+ * @brief Initializes the reference tables of the I/Q demodulator.
+ *
+ * This function fills one TX period of cosine and negative sine values, one
+ * multi-tone period of them for every tone, and computes the scale that makes the demodulated magnitude comparable with the
+ * magnitude produced by sig_perform_fft(), in units of a 12-bit code whatever the resolution of the front-end.
+ *
+ * @param handle Pointer to the IQ_Handle_t structure.
+ */
+void iq_init(IQ_Handle_t *const handle)
+{
+    for(size_t i = 0; i < IQ_REF_TABLE_LEN; i++)
+    {
+        float32_t angle = 2.0f * PI * (float32_t)i / (float32_t)IQ_REF_TABLE_LEN;
+
+        handle->ref_cos[i] = cosf(angle);
+        handle->ref_sin[i] = -sinf(angle);
+    }
+
+    handle->scale = 1.0f / (float32_t)( IQ_BLOCK_LEN << SIG_CODE_SHIFT );
+
+    /* Tone t completes cycles[t] periods per multi-tone table */
+    for(size_t t = 0; t < IQ_TONE_COUNT; t++)
+    {
+        for(size_t i = 0; i < IQ_TONE_TABLE_LEN; i++)
+        {
+            float32_t angle = 2.0f * PI * (float32_t)(OUTPUT_MULTITONE_CYCLES[t] * i % IQ_TONE_TABLE_LEN) / (float32_t)IQ_TONE_TABLE_LEN;
+
+            handle->tone_cos[t][i] = cosf(angle);
+            handle->tone_sin[t][i] = -sinf(angle);
+        }
+    }
+
+    handle->tone_scale = 1.0f / (float32_t)( IQ_TONE_BLOCK_LEN << SIG_CODE_SHIFT );
+}
+
+
+/**
+ * @brief Demodulates the TX frequency component of both coil signals.
+ *
+ * This function correlates IQ_BLOCK_LEN samples of the ADC buffer view with
+ * the reference tables and converts the resulting complex values to the
+ * magnitudes and cross spectrum expected by md_detect(). Only two square
+ * roots and no arctangent are computed per block.
+ *
+ * @param handle Pointer to the IQ_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure holding the ADC samples.
+ * @param data Pointer to the MD_Data_t structure that receives the magnitude and the cross spectrum.
+ */
+void iq_demodulate(const IQ_Handle_t *const handle, const SIG_View_t *const view, MD_Data_t *const data)
+{
+    const SIG_ADCRegister_t *samples = view->samples;
+    float32_t tx_real = 0, tx_imag = 0;
+    float32_t rx_real = 0, rx_imag = 0;
+
+    /* Correlate both channels with the reference, one TX period at a time */
+    for(size_t n = 0; n < IQ_BLOCK_LEN; n += IQ_REF_TABLE_LEN)
+    {
+        for(size_t k = 0; k < IQ_REF_TABLE_LEN; k++)
+        {
+            float32_t tx = (float32_t)( (int32_t)samples[n + k].adc1 - ADC_MID_SCALE );
+            float32_t rx = (float32_t)( (int32_t)samples[n + k].adc2 - ADC_MID_SCALE );
+
+            tx_real += tx * handle->ref_cos[k];
+            tx_imag += tx * handle->ref_sin[k];
+            rx_real += rx * handle->ref_cos[k];
+            rx_imag += rx * handle->ref_sin[k];
+        }
+    }
+
+    rx_real *= handle->scale;
+    rx_imag *= handle->scale;
+    tx_real *= handle->scale;
+    tx_imag *= handle->scale;
+
+    /* Magnitudes of both components and cross spectrum RX * conj(TX) */
+    data->rx_signal_magnitude = sqrtf(rx_real * rx_real + rx_imag * rx_imag);
+    data->tx_signal_magnitude = sqrtf(tx_real * tx_real + tx_imag * tx_imag);
+    data->cross_real = rx_real * tx_real + rx_imag * tx_imag;
+    data->cross_imag = rx_imag * tx_real - rx_real * tx_imag;
+    data->tone_count = 0;
+}
+
+
+/**
+ * @brief Demodulates every tone of the multi-tone TX signal in one pass.
+ *
+ * This function reads each sample of the ADC buffer view once
+ * and correlates it with the references of all tones. The tones complete whole
+ * periods within the block, so they do not leak into each other. The primary
+ * tone is also copied to the scalar fields, so md_detect() works unchanged.
+ *
+ * @param handle Pointer to the IQ_Handle_t structure.
+ * @param view Pointer to the SIG_View_t structure holding the ADC samples.
+ * @param data Pointer to the MD_Data_t structure that receives the per-tone values.
+ */
+void iq_demodulate_multi(const IQ_Handle_t *const handle, const SIG_View_t *const view, MD_Data_t *const data)
+{
+    const SIG_ADCRegister_t *samples = view->samples;
+    float32_t tx_real[IQ_TONE_COUNT] = {0}, tx_imag[IQ_TONE_COUNT] = {0};
+    float32_t rx_real[IQ_TONE_COUNT] = {0}, rx_imag[IQ_TONE_COUNT] = {0};
+
+    /* Correlate both channels with the references of all tones */
+    for(size_t n = 0; n < IQ_TONE_BLOCK_LEN; n += IQ_TONE_TABLE_LEN)
+    {
+        for(size_t k = 0; k < IQ_TONE_TABLE_LEN; k++)
+        {
+            float32_t tx = (float32_t)( (int32_t)samples[n + k].adc1 - ADC_MID_SCALE );
+            float32_t rx = (float32_t)( (int32_t)samples[n + k].adc2 - ADC_MID_SCALE );
+
+            for(size_t t = 0; t < IQ_TONE_COUNT; t++)
+            {
+                tx_real[t] += tx * handle->tone_cos[t][k];
+                tx_imag[t] += tx * handle->tone_sin[t][k];
+                rx_real[t] += rx * handle->tone_cos[t][k];
+                rx_imag[t] += rx * handle->tone_sin[t][k];
+            }
+        }
+    }
+
+    /* Magnitudes and cross spectrum of every tone */
+    for(size_t t = 0; t < IQ_TONE_COUNT; t++)
+    {
+        float32_t real = rx_real[t] * handle->tone_scale;
+        float32_t imag = rx_imag[t] * handle->tone_scale;
+        float32_t tx_re = tx_real[t] * handle->tone_scale;
+        float32_t tx_im = tx_imag[t] * handle->tone_scale;
+
+        data->tones[t].rx_signal_magnitude = sqrtf(real * real + imag * imag);
+        data->tones[t].tx_signal_magnitude = sqrtf(tx_re * tx_re + tx_im * tx_im);
+        data->tones[t].cross_real = real * tx_re + imag * tx_im;
+        data->tones[t].cross_imag = imag * tx_re - real * tx_im;
+    }
+
+    data->tone_count = IQ_TONE_COUNT;
+    data->rx_signal_magnitude = data->tones[0].rx_signal_magnitude;
+    data->tx_signal_magnitude = data->tones[0].tx_signal_magnitude;
+    data->cross_real = data->tones[0].cross_real;
+    data->cross_imag = data->tones[0].cross_imag;
+}
+
+
+/**
+ * @brief Measures the cycle count of the FFT path and the I/Q path on the same block.
+ *
+ * This function runs all demodulation paths on the same ADC buffer
+ * view and stores the number of CPU cycles each of them took. The cycle
+ * counter must be enabled with cc_init() beforehand.
+ *
+ * @param handle Pointer to the IQ_Handle_t structure.
+ * @param sig Pointer to the SIG_Handle_t structure used by the FFT path.
+ * @param view Pointer to the SIG_View_t structure holding the ADC samples.
+ * @param result Pointer to the IQ_Benchmark_t structure that receives the cycle counts.
+ */
+void iq_benchmark(const IQ_Handle_t *const handle, SIG_Handle_t *const sig, const SIG_View_t *const view, IQ_Benchmark_t *const result)
+{
+    MD_Data_t data = {0};
+    SIG_CrossSpectrum_t cross = {0};
+    uint32_t start = 0;
+
+    /* Full-spectrum path: sample conversion, the FFTs and the cross spectrum of the TX bin */
+    start = cc_get();
+    sig_load_samples(sig, view);
+    (void) sig_perform_fft(sig);
+    sig_cross_spectrum(sig, &cross);
+    result->fft_cycles = cc_get() - start;
+
+    /* Single-bin path */
+    start = cc_get();
+    iq_demodulate(handle, view, &data);
+    result->iq_cycles = cc_get() - start;
+
+    /* Single pass over all multi-tone tones */
+    start = cc_get();
+    iq_demodulate_multi(handle, view, &data);
+    result->multi_cycles = cc_get() - start;
+}
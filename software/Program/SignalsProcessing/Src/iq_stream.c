@@ -0,0 +1,237 @@
+/**
+ * @file iq_stream.c
+ * @brief Implementation file for the continuous demodulated I/Q stream.
+ *
+ * This file contains the mixer, the decimator and the ring of the I/Q stream.
+ * The decimation averages the mixed samples over IQS_DECIMATION samples and
+ * then starts over. As the average always spans whole multi-tone periods, the
+ * other tones, the harmonics of the TX frequency and the mixing products at
+ * twice the TX frequency all fall exactly into zeros of its response.
+ *
+ * The reference phase follows the input buffer index, which is a multiple of
+ * the TX period at the start of the buffer, so the phase stays the same after
+ * a restart. A restart loses the partial I/Q sample and marks the next one as
+ * not continuous, so consumers can reset their filters.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include "iq_stream.h"
+
+#if ( INPUT_BUFF_LEN % IQS_REF_TABLE_LEN ) != 0
+#error "INPUT_BUFF_LEN must hold whole TX periods"
+#endif
+
+/** @brief Global handle for the I/Q stream. */
+IQS_Handle_t iqs_handle = {0};
+
+
+/**
+ * @brief Discards the partial I/Q sample and continues mixing at the given input buffer index.
+ *
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param write_index Current DMA write index.
+ */
+static void iqs_restart(IQS_Handle_t *const handle, uint16_t write_index)
+{
+    handle->tx_real = 0;
+    handle->tx_imag = 0;
+    handle->rx_real = 0;
+    handle->rx_imag = 0;
+    handle->mixed = 0;
+
+    handle->read_index = write_index;
+    handle->continuous = 0;
+}
+
+
+/**
+ * @brief Initializes the I/Q stream and starts mixing at the given input buffer index.
+ *
+ * This function fills the reference tables, empties the ring and computes the
+ * scale that makes the I/Q magnitude comparable with the magnitude produced by
+ * sig_perform_fft(), in units of a 12-bit code.
+ *
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param write_index Current DMA write index, see sig_get_write_index().
+ */
+void iqs_init(IQS_Handle_t *const handle, uint16_t write_index)
+{
+    for(size_t i = 0; i < IQS_REF_TABLE_LEN; i++)
+    {
+        float32_t angle = 2.0f * PI * (float32_t)i / (float32_t)IQS_REF_TABLE_LEN;
+
+        handle->ref_cos[i] = (int16_t) lroundf(cosf(angle) * (float32_t)(1 << IQS_REF_FRAC_BITS));
+        handle->ref_sin[i] = (int16_t) lroundf(-sinf(angle) * (float32_t)(1 << IQS_REF_FRAC_BITS));
+    }
+
+    handle->scale = 1.0f / ( (float32_t)IQS_DECIMATION * (float32_t)(1 << (IQS_REF_FRAC_BITS + SIG_CODE_SHIFT)) );
+
+    handle->max_backlog = 0;
+    handle->restarts = 0;
+    handle->write_index = 0;
+
+    iqs_restart(handle, write_index);
+
+    /* Nothing was lost before the first I/Q sample */
+    handle->continuous = 1;
+}
+
+
+/**
+ * @brief Mixes all new samples and appends the completed I/Q samples to the ring.
+ *
+ * When the backlog exceeds IQS_MAX_BACKLOG the samples may already be
+ * overwritten, so the stream restarts at the current DMA position. A new I/Q
+ * sample is visible to the readers only after its slot is complete.
+ *
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param sig Pointer to the SIG_Handle_t structure holding the ADC samples.
+ * @param write_index Current DMA write index, see sig_get_write_index().
+ * @return uint32_t Number of I/Q samples appended.
+ */
+uint32_t iqs_update(IQS_Handle_t *const handle, const SIG_Handle_t *const sig, uint16_t write_index)
+{
+    uint16_t backlog = (uint16_t)( (write_index + INPUT_BUFF_LEN - handle->read_index) % INPUT_BUFF_LEN );
+    size_t index = handle->read_index;
+    size_t k = index % IQS_REF_TABLE_LEN;
+    uint32_t produced = 0;
+
+    if (backlog > handle->max_backlog)
+    {
+        handle->max_backlog = backlog;
+    }
+
+    if (backlog > IQS_MAX_BACKLOG)
+    {
+        handle->restarts++;
+        iqs_restart(handle, write_index);
+        return 0;
+    }
+
+    for(size_t i = 0; i < backlog; i++)
+    {
+        int32_t tx = (int32_t)sig->input_sig[index].adc1 - sig->dc_offset;
+        int32_t rx = (int32_t)sig->input_sig[index].adc2 - sig->dc_offset;
+
+        handle->tx_real += tx * handle->ref_cos[k];
+        handle->tx_imag += tx * handle->ref_sin[k];
+        handle->rx_real += rx * handle->ref_cos[k];
+        handle->rx_imag += rx * handle->ref_sin[k];
+
+        if (++index == INPUT_BUFF_LEN)
+        {
+            index = 0;
+        }
+        if (++k == IQS_REF_TABLE_LEN)
+        {
+            k = 0;
+        }
+
+        if (++handle->mixed == IQS_DECIMATION)
+        {
+            uint32_t sequence = handle->write_index;
+            IQS_Sample_t *slot = &handle->slots[sequence & (IQS_RING_LEN - 1)];
+
+            slot->sequence = sequence;
+            slot->rx_real = (float32_t)handle->rx_real * handle->scale;
+            slot->rx_imag = (float32_t)handle->rx_imag * handle->scale;
+            slot->tx_real = (float32_t)handle->tx_real * handle->scale;
+            slot->tx_imag = (float32_t)handle->tx_imag * handle->scale;
+            slot->continuous = handle->continuous;
+
+            /* The slot must be complete before the readers can see it */
+            __DMB();
+            handle->write_index = sequence + 1;
+            produced++;
+
+            handle->tx_real = 0;
+            handle->tx_imag = 0;
+            handle->rx_real = 0;
+            handle->rx_imag = 0;
+            handle->mixed = 0;
+            handle->continuous = 1;
+        }
+    }
+
+    handle->read_index = (uint16_t) index;
+
+    return produced;
+}
+
+
+/**
+ * @brief Starts a reader at the newest I/Q sample.
+ *
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param reader Pointer to the IQS_Reader_t structure of the consumer.
+ */
+void iqs_reader_init(const IQS_Handle_t *const handle, IQS_Reader_t *const reader)
+{
+    reader->index = handle->write_index;
+    reader->received = 0;
+    reader->lost = 0;
+}
+
+
+/**
+ * @brief Reads the oldest I/Q sample the reader has not read yet.
+ *
+ * A reader that fell IQS_RING_LEN samples behind continues with the oldest
+ * sample that cannot be overwritten during the copy, and counts the skipped
+ * samples as lost. The copy is repeated if the writer still reached its slot,
+ * which can only happen if the reader was preempted for a long time.
+ *
+ * @param handle Pointer to the IQS_Handle_t structure.
+ * @param reader Pointer to the IQS_Reader_t structure of the consumer.
+ * @param sample Pointer to the IQS_Sample_t structure that receives the I/Q sample.
+ * @return IQS_Status_t IQS_OK if an I/Q sample was read, IQS_EMPTY otherwise.
+ */
+IQS_Status_t iqs_read(const IQS_Handle_t *const handle, IQS_Reader_t *const reader, IQS_Sample_t *const sample)
+{
+    uint32_t write_index = 0;
+
+    do
+    {
+        write_index = handle->write_index;
+        if (write_index == reader->index)
+        {
+            return IQS_EMPTY;
+        }
+
+        /* The slot of write_index may be being written */
+        if ( (write_index - reader->index) >= IQS_RING_LEN )
+        {
+            reader->lost += write_index - reader->index - IQS_RING_LEN + 1;
+            reader->index = write_index - IQS_RING_LEN + 1;
+        }
+
+        /* Read the slot only after the write index that published it */
+        __DMB();
+        *sample = handle->slots[reader->index & (IQS_RING_LEN - 1)];
+        __DMB();
+    } while ( (handle->write_index - reader->index) >= IQS_RING_LEN );
+
+    reader->index++;
+    reader->received++;
+
+    return IQS_OK;
+}
+
+
+/**
+ * @brief Converts an I/Q sample to the magnitude and cross spectrum of the detector.
+ *
+ * @param sample Pointer to the IQS_Sample_t structure.
+ * @param data Pointer to the MD_Data_t structure that receives the magnitude and the cross spectrum.
+ */
+void iqs_to_data(const IQS_Sample_t *const sample, MD_Data_t *const data)
+{
+    data->rx_signal_magnitude = sqrtf(sample->rx_real * sample->rx_real + sample->rx_imag * sample->rx_imag);
+    data->tx_signal_magnitude = sqrtf(sample->tx_real * sample->tx_real + sample->tx_imag * sample->tx_imag);
+    data->cross_real = sample->rx_real * sample->tx_real + sample->rx_imag * sample->tx_imag;
+    data->cross_imag = sample->rx_imag * sample->tx_real - sample->rx_real * sample->tx_imag;
+    data->tone_count = 0;
+}
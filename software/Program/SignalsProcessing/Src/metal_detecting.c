@@ -6,33 +6,57 @@
  * It includes functions for detecting targets based on signal magnitude and phase difference,
  * as well as setting ground balance and sensitivity parameters.
  *
+ * The static detector compares the magnitude with the one of the previous
+ * frame only, so it misses slow sweeps and triggers on single noisy frames.
+ * The motion detector instead tracks the background vector in the complex
+ * plane with a first-order IIR low-pass and detects the deviation from it,
+ * which is the high-pass filtered signal, with separate detect and release
+ * thresholds. It takes one division and about twenty other floating-point
+ * operations per frame, plus a square root and an arctangent while a target
+ * is detected.
+ *
  * Created on: Jul 23, 2024
  * Author: Viktor
  */
 
+#include <math.h>
 #include "metal_detecting.h"
 #include "app_signal.h"
+#include "fast_math.h"
 
 /** @brief Global handle for metal detecting operations. */
 MD_Handle_t md_handle = {0 };
 
 
 /**
- * @brief Detects the presence of a target based on signal magnitude and phase difference.
+ * @brief Selects the default detector and sets the frame period of the motion detector.
  *
- * This function determines if a target is detected by comparing the current signal magnitude
- * with a ground balance and sensitivity threshold. It also calculates the phase difference between
- * the transmitted and received signals.
+ * The ground balance, the sensitivity and the phase mode are kept, as the GUI
+ * may have set them already.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param update_period_ms Time between two calls of md_detect() in milliseconds.
+ */
+void md_init(MD_Handle_t *const handle, float32_t update_period_ms)
+{
+    handle->motion.update_period_ms = update_period_ms;
+
+    md_set_motion_cutoff(handle, MD_MOTION_CUTOFF_HZ);
+    md_set_detector(handle, MD_DEFAULT_DETECTOR);
+}
+
+
+/**
+ * @brief Detects a target as a step of the magnitude from the previous frame.
  *
  * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
  * @param data Pointer to the MD_Data_t structure containing the received signal data.
  * @param phase_difference Pointer to an integer where the calculated phase difference will be stored.
  * @return MD_DetectStatus_t Detection status indicating whether a target was detected or not.
  */
-MD_DetectStatus_t md_detect(MD_Handle_t *const handle, const MD_Data_t *const data, int16_t *const phase_difference)
+static MD_DetectStatus_t md_detect_static(MD_Handle_t *const handle, const MD_Data_t *const data, int16_t *const phase_difference)
 {
     MD_DetectStatus_t return_value = NO_TARGET;        /*!< Default return value indicating no target detected */
-    float32_t phase_difference_float = 0;              /*!< Variable to hold the calculated phase difference */
 
     /* Check if the received signal magnitude exceeds the ground balance */
     if( data->rx_signal_magnitude > handle->gnd_balance )
@@ -43,29 +67,143 @@ MD_DetectStatus_t md_detect(MD_Handle_t *const handle, const MD_Data_t *const da
             return_value = TARGET_DETECTED;  /*!< Set the return value to indicate that a target is detected */
 
             /* Calculate the phase difference between the transmitted and received signals */
-            phase_difference_float = data->tx_signal_phase - data->rx_signal_phase;
-            phase_difference_float *= 180.0f / PI;  /*!< Convert phase difference to degrees */
-
-            /* Normalize phase difference to the range of [-180, 180] degrees */
-            if (phase_difference_float > 180.0f)
-            {
-                phase_difference_float -= 360.0f;
-            }
-            else if (phase_difference_float < -180.0f)
-            {
-                phase_difference_float += 360.0f;
-            }
-
-            phase_difference_float = fabs(phase_difference_float);  /*!< Take the absolute value of the phase difference */
-
-            *phase_difference = (int32_t) phase_difference_float;  /*!< Store the phase difference in the provided pointer */
+            *phase_difference = (int16_t) md_phase_difference(data->cross_real, data->cross_imag, handle->phase_mode);
+            handle->target_magnitude = data->rx_signal_magnitude - handle->gnd_balance;
         }
     }
 
+    return return_value;  /*!< Return the detection status */
+}
+
+
+/**
+ * @brief Detects a target as a deviation of the RX vector from the tracked background.
+ *
+ * The RX vector referenced to the TX phase is the cross spectrum divided by
+ * the TX magnitude. A target is detected while its distance from the
+ * background exceeds the sensitivity, and released once it falls below
+ * MD_MOTION_RELEASE_RATIO times the sensitivity. While a target is detected
+ * the background follows MD_MOTION_HOLD_FACTOR times slower, so the target is
+ * not absorbed into it during a slow sweep and leaves no undershoot behind,
+ * while a target that stays in place still fades out eventually. The phase
+ * is the one of the deviation, so the ground under the coil does not shift
+ * it. With a ground balance only the part of the deviation perpendicular to
+ * the ground is detected and reported as the magnitude, so pumping the coil
+ * over the ground is not taken for a target.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param data Pointer to the MD_Data_t structure containing the received signal data.
+ * @param phase_difference Pointer to an integer where the calculated phase difference will be stored.
+ * @return MD_DetectStatus_t Detection status indicating whether a target was detected or not.
+ */
+static MD_DetectStatus_t md_detect_motion(MD_Handle_t *const handle, const MD_Data_t *const data, int16_t *const phase_difference)
+{
+    MD_Motion_t *const motion = &handle->motion;
+    float32_t scale = 0, real = 0, imag = 0;
+    float32_t deviation_real = 0, deviation_imag = 0, deviation_power = 0, detection_power = 0;
+    float32_t threshold = 0, alpha = 0;
+
+    /* Without the TX signal there is no phase reference */
+    if( data->tx_signal_magnitude <= 0.0f )
+    {
+        return NO_TARGET;
+    }
+
+    scale = 1.0f / data->tx_signal_magnitude;
+    real = data->cross_real * scale;
+    imag = data->cross_imag * scale;
+
+    if( motion->primed == 0 )
+    {
+        motion->background_real = real;
+        motion->background_imag = imag;
+        motion->active = 0;
+        motion->primed = 1;
+    }
+
+    deviation_real = real - motion->background_real;
+    deviation_imag = imag - motion->background_imag;
+    deviation_power = deviation_real * deviation_real + deviation_imag * deviation_imag;
+    detection_power = deviation_power;
+
+    if( (data->ground_real != 0.0f) || (data->ground_imag != 0.0f) )
+    {
+        /* Imaginary part of deviation * conj(ground) */
+        float32_t perpendicular = deviation_imag * data->ground_real - deviation_real * data->ground_imag;
+
+        detection_power = perpendicular * perpendicular;
+    }
+
+    /* Compare the squared distance with the squared threshold of the current state */
+    threshold = motion->active ? handle->sensitivity * MD_MOTION_RELEASE_RATIO : handle->sensitivity;
+    motion->active = ( detection_power > threshold * threshold ) ? 1 : 0;
+
+    alpha = motion->active ? motion->alpha * MD_MOTION_HOLD_FACTOR : motion->alpha;
+    motion->background_real += alpha * deviation_real;
+    motion->background_imag += alpha * deviation_imag;
+
+    if( motion->active == 0 )
+    {
+        return NO_TARGET;
+    }
+
+    *phase_difference = (int16_t) md_phase_difference(deviation_real, deviation_imag, handle->phase_mode);
+    handle->target_magnitude = sqrtf(detection_power);
+
+    return TARGET_DETECTED;
+}
+
+
+/**
+ * @brief Detects the presence of a target with the selected detector.
+ *
+ * This function determines if a target is detected with the detector selected by
+ * md_set_detector(). It also calculates the phase difference between the transmitted
+ * and received signals from the cross spectrum, in the sign convention selected
+ * with md_set_phase_mode(), and the magnitude of the target in target_magnitude.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param data Pointer to the MD_Data_t structure containing the received signal data.
+ * @param phase_difference Pointer to an integer where the calculated phase difference will be stored.
+ * @return MD_DetectStatus_t Detection status indicating whether a target was detected or not.
+ */
+MD_DetectStatus_t md_detect(MD_Handle_t *const handle, const MD_Data_t *const data, int16_t *const phase_difference)
+{
+    MD_DetectStatus_t return_value = NO_TARGET;
+
+    if( handle->detector == MD_DETECTOR_MOTION )
+    {
+        return_value = md_detect_motion(handle, data, phase_difference);
+    }
+    else
+    {
+        return_value = md_detect_static(handle, data, phase_difference);
+    }
+
     /* Update the last magnitude with the current signal magnitude */
     handle->last_magnitude = data->rx_signal_magnitude;
 
-    return return_value;  /*!< Return the detection status */
+    return return_value;
+}
+
+
+/**
+ * @brief Returns the phase difference between the transmitted and received signals.
+ *
+ * The angle of RX * conj(TX) is the RX phase minus the TX phase, already in
+ * the range -180..180 degrees, so its negation gives the TX phase minus the RX
+ * phase without any wrap-around correction.
+ *
+ * @param cross_real Real part of the cross spectrum RX * conj(TX).
+ * @param cross_imag Imaginary part of the cross spectrum RX * conj(TX).
+ * @param mode Sign convention of the result.
+ * @return float32_t Phase difference in degrees.
+ */
+float32_t md_phase_difference(float32_t cross_real, float32_t cross_imag, MD_PhaseMode_t mode)
+{
+    float32_t phase = fm_atan2f(-cross_imag, cross_real) * (180.0f / PI);
+
+    return (mode == MD_PHASE_SIGNED) ? phase : fabsf(phase);
 }
 
 
@@ -95,3 +233,47 @@ void md_set_sensitivity(MD_Handle_t *const handle, const uint16_t new_sens)
 {
     handle->sensitivity = (float32_t)new_sens;  /*!< Update the sensitivity parameter */
 }
+
+
+/**
+ * @brief Selects the sign convention of the phase difference reported by md_detect().
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param mode MD_PHASE_UNSIGNED (default) or MD_PHASE_SIGNED.
+ */
+void md_set_phase_mode(MD_Handle_t *const handle, MD_PhaseMode_t mode)
+{
+    handle->phase_mode = mode;
+}
+
+
+/**
+ * @brief Selects the detector used by md_detect() and restarts the motion detector.
+ *
+ * The motion detector starts tracking the background from the next frame.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param detector MD_DETECTOR_STATIC or MD_DETECTOR_MOTION.
+ */
+void md_set_detector(MD_Handle_t *const handle, MD_Detector_t detector)
+{
+    handle->motion.primed = 0;
+    handle->motion.active = 0;
+    handle->detector = detector;
+}
+
+
+/**
+ * @brief Sets the cutoff frequency of the background high-pass of the motion detector.
+ *
+ * The weight of a new frame is 1 - exp(-2 * pi * fc * T), T being the frame
+ * period given to md_init(). A target passing the coil within about
+ * 1 / (2 * pi * fc) seconds or faster is detected with its full magnitude.
+ *
+ * @param handle Pointer to the MD_Handle_t structure containing detection parameters.
+ * @param cutoff_hz Cutoff frequency in Hz, a lower one also detects slower sweeps.
+ */
+void md_set_motion_cutoff(MD_Handle_t *const handle, float32_t cutoff_hz)
+{
+    handle->motion.alpha = 1.0f - expf(-2.0f * PI * cutoff_hz * handle->motion.update_period_ms / 1000.0f);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file packed_fft.c
+ * @brief Implementation file for the split of a packed complex FFT into the spectra of two real signals.
+ *
+ * This file contains the split of the packed transform. Since tx and rx are
+ * both real, their spectra follow from the conjugate symmetry of Z[k]:
+ * TX[k] = (Z[k] + conj(Z[N - k])) / 2 and RX[k] = (Z[k] - conj(Z[N - k])) / 2j.
+ * The DC and Nyquist bins of both signals are real, so they are stored in the
+ * real and imaginary part of bin 0, as arm_rfft_fast_f32() does.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include "packed_fft.h"
+
+
+/**
+ * @brief Splits the spectrum of z[n] = tx[n] + j * rx[n] into the spectra of tx and rx.
+ *
+ * The output buffers must not overlap the packed spectrum.
+ *
+ * @param packed Spectrum of z, len interleaved complex values as produced by arm_cfft_f32().
+ * @param len Transform length, even.
+ * @param tx Spectrum of tx, len / 2 interleaved complex values in the layout of arm_rfft_fast_f32().
+ * @param rx Spectrum of rx, in the same layout as tx.
+ */
+void pfft_split(const float32_t *packed, size_t len, float32_t *tx, float32_t *rx)
+{
+    /* DC and Nyquist bins are real for both signals */
+    tx[0] = packed[0];
+    tx[1] = packed[len];
+    rx[0] = packed[1];
+    rx[1] = packed[len + 1];
+
+    /* Split the remaining bins with the conjugate symmetry identity */
+    for(size_t k = 1; k < len / 2; k++)
+    {
+        const float32_t *bin = &packed[2 * k];
+        const float32_t *mirror = &packed[2 * (len - k)];
+        float32_t sum_real = bin[0] + mirror[0];
+        float32_t sum_imag = bin[1] - mirror[1];
+        float32_t diff_real = bin[0] - mirror[0];
+        float32_t diff_imag = bin[1] + mirror[1];
+
+        tx[2 * k] = 0.5f * sum_real;
+        tx[2 * k + 1] = 0.5f * sum_imag;
+        rx[2 * k] = 0.5f * diff_imag;
+        rx[2 * k + 1] = -0.5f * diff_real;
+    }
+}
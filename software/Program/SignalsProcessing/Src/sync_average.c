@@ -0,0 +1,292 @@
+/**
+ * @file sync_average.c
+ * @brief Implementation file for the synchronous averaging of the demodulated TX tone.
+ *
+ * This file contains the exponential averaging of the cross spectrum and the
+ * TX magnitude of every tone. The averaged RX magnitude is the magnitude of
+ * the averaged cross spectrum divided by the averaged TX magnitude, so the
+ * noise is averaged out before the magnitude and the phase are taken, instead
+ * of biasing the magnitude upwards as an average of magnitudes would.
+ *
+ * A weight alpha of a new result gives a noise power reduction of
+ * (2 - alpha) / alpha, e.g. 11.7 dB for a 50 ms time constant at a result
+ * every 6.8 ms. The host test in Program/Tests measures it, and checks that
+ * the fast attack and decay do not reduce it.
+ *
+ * The fast attack only helps a target that appears. Without a fast decay the
+ * slow average would still hold most of a target that has left for the time
+ * constant, so every detection event would end about 50 ms late. The decay
+ * average follows the signal with the shorter SA_DECAY_TIME_MS and takes
+ * over when the signal falls by more than its own noise, in the same way as
+ * the attack average does for a rise.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include <string.h>
+#include "sync_average.h"
+
+/** @brief Global handle for the synchronous averager. */
+SA_Handle_t sa_handle = {0};
+
+
+/**
+ * @brief Returns the weight of a new result for the given time constant.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param time_constant_ms Time constant in milliseconds, 0 for no averaging.
+ * @return float32_t Weight in the range 0..1.
+ */
+static float32_t sa_alpha(const SA_Handle_t *const handle, float32_t time_constant_ms)
+{
+    if (time_constant_ms <= 0.0f)
+    {
+        return 1.0f;
+    }
+
+    return 1.0f - expf(-handle->update_period_ms / time_constant_ms);
+}
+
+
+/**
+ * @brief Averages the values of one tone and writes the averaged values back.
+ *
+ * The attack average follows the cross spectrum with the attack time. When
+ * it is larger than the slow average and their difference exceeds
+ * SA_ATTACK_THRESHOLD times the noise of the attack average, the signal is
+ * rising and the slow average continues from the attack average. The decay
+ * average does the same with the decay time when it is smaller than the slow
+ * average, the signal is then falling. The noise itself never gets that far,
+ * so it is still averaged with the time constant.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param channel Pointer to the SA_Channel_t structure of the tone.
+ * @param magnitude Pointer to the RX magnitude, replaced by the averaged one.
+ * @param cross_real Pointer to the real part of the cross spectrum, replaced by its average.
+ * @param cross_imag Pointer to the imaginary part of the cross spectrum, replaced by its average.
+ * @param tx_magnitude TX magnitude of the new result.
+ */
+static void sa_average(const SA_Handle_t *const handle, SA_Channel_t *const channel, float32_t *const magnitude,
+                       float32_t *const cross_real, float32_t *const cross_imag, float32_t tx_magnitude)
+{
+    const float32_t alpha = handle->release_alpha;
+    const float32_t attack = handle->attack_alpha;
+    const float32_t decay = handle->decay_alpha;
+    float32_t error_real = *cross_real - channel->cross_real;
+    float32_t error_imag = *cross_imag - channel->cross_imag;
+
+    if (handle->primed == 0)
+    {
+        channel->cross_real = *cross_real;
+        channel->cross_imag = *cross_imag;
+        channel->attack_real = *cross_real;
+        channel->attack_imag = *cross_imag;
+        channel->decay_real = *cross_real;
+        channel->decay_imag = *cross_imag;
+        channel->noise_power = 0.0f;
+        channel->tx_magnitude = tx_magnitude;
+    }
+    else
+    {
+        const float32_t power = channel->cross_real * channel->cross_real + channel->cross_imag * channel->cross_imag;
+        uint8_t rising = 0, falling = 0;
+
+        channel->cross_real += alpha * error_real;
+        channel->cross_imag += alpha * error_imag;
+        channel->tx_magnitude += alpha * (tx_magnitude - channel->tx_magnitude);
+
+        if (attack > alpha)
+        {
+            float32_t rise_real = 0, rise_imag = 0;
+
+            channel->attack_real += attack * (*cross_real - channel->attack_real);
+            channel->attack_imag += attack * (*cross_imag - channel->attack_imag);
+
+            rise_real = channel->attack_real - channel->cross_real;
+            rise_imag = channel->attack_imag - channel->cross_imag;
+
+            rising = (channel->attack_real * channel->attack_real + channel->attack_imag * channel->attack_imag > power) &&
+                     (rise_real * rise_real + rise_imag * rise_imag > handle->attack_limit * channel->noise_power);
+        }
+
+        if (decay > alpha)
+        {
+            float32_t fall_real = 0, fall_imag = 0;
+
+            channel->decay_real += decay * (*cross_real - channel->decay_real);
+            channel->decay_imag += decay * (*cross_imag - channel->decay_imag);
+
+            fall_real = channel->decay_real - channel->cross_real;
+            fall_imag = channel->decay_imag - channel->cross_imag;
+
+            falling = (channel->decay_real * channel->decay_real + channel->decay_imag * channel->decay_imag < power) &&
+                      (fall_real * fall_real + fall_imag * fall_imag > handle->decay_limit * channel->noise_power);
+        }
+
+        if (rising)
+        {
+            channel->cross_real = channel->attack_real;
+            channel->cross_imag = channel->attack_imag;
+            channel->decay_real = channel->attack_real;
+            channel->decay_imag = channel->attack_imag;
+        }
+        else if (falling)
+        {
+            channel->cross_real = channel->decay_real;
+            channel->cross_imag = channel->decay_imag;
+            channel->attack_real = channel->decay_real;
+            channel->attack_imag = channel->decay_imag;
+        }
+        else
+        {
+            /* A rising or falling signal is not noise */
+            channel->noise_power += alpha * (error_real * error_real + error_imag * error_imag - channel->noise_power);
+        }
+    }
+
+    *cross_real = channel->cross_real;
+    *cross_imag = channel->cross_imag;
+
+    if (channel->tx_magnitude > 0.0f)
+    {
+        *magnitude = sqrtf(channel->cross_real * channel->cross_real + channel->cross_imag * channel->cross_imag) / channel->tx_magnitude;
+    }
+    else
+    {
+        *magnitude = 0.0f;
+    }
+}
+
+
+/**
+ * @brief Initializes the averager with the default time constants.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param update_period_ms Time between two results in milliseconds.
+ */
+void sa_init(SA_Handle_t *const handle, float32_t update_period_ms)
+{
+    handle->update_period_ms = update_period_ms;
+
+    sa_set_time_constant(handle, SA_TIME_CONSTANT_MS);
+    sa_set_attack_time(handle, SA_ATTACK_TIME_MS);
+    sa_set_decay_time(handle, SA_DECAY_TIME_MS);
+    sa_reset(handle);
+}
+
+
+/**
+ * @brief Sets the time constant of the average.
+ *
+ * The attack and decay times are kept, but never make the average slower
+ * than this time constant.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param time_constant_ms Time constant in milliseconds, 0 disables the averaging.
+ */
+void sa_set_time_constant(SA_Handle_t *const handle, float32_t time_constant_ms)
+{
+    handle->release_alpha = sa_alpha(handle, time_constant_ms);
+
+    if (handle->attack_alpha < handle->release_alpha)
+    {
+        handle->attack_alpha = handle->release_alpha;
+        handle->attack_limit = SA_ATTACK_THRESHOLD * SA_ATTACK_THRESHOLD * handle->attack_alpha / (2.0f - handle->attack_alpha);
+    }
+
+    if (handle->decay_alpha < handle->release_alpha)
+    {
+        handle->decay_alpha = handle->release_alpha;
+        handle->decay_limit = SA_ATTACK_THRESHOLD * SA_ATTACK_THRESHOLD * handle->decay_alpha / (2.0f - handle->decay_alpha);
+    }
+}
+
+
+/**
+ * @brief Sets the attack time used while the signal rises above the average.
+ *
+ * An approaching target then shows up after about the attack time instead of
+ * the time constant. The noise power of an average with weight alpha is
+ * alpha / (2 - alpha) times the noise power of a single result, which sets
+ * the rise that counts as a signal.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param attack_time_ms Attack time in milliseconds, 0 disables the fast attack.
+ */
+void sa_set_attack_time(SA_Handle_t *const handle, float32_t attack_time_ms)
+{
+    float32_t attack = (attack_time_ms > 0.0f) ? sa_alpha(handle, attack_time_ms) : handle->release_alpha;
+
+    if (attack < handle->release_alpha)
+    {
+        attack = handle->release_alpha;
+    }
+
+    handle->attack_limit = SA_ATTACK_THRESHOLD * SA_ATTACK_THRESHOLD * attack / (2.0f - attack);
+    handle->attack_alpha = attack;
+}
+
+
+/**
+ * @brief Sets the decay time used while the signal falls below the average.
+ *
+ * A target that leaves then drops out of the average after about the decay
+ * time instead of the time constant, so the end of a detection event is not
+ * delayed by the slow average. The fall that counts as a signal is set by the
+ * noise of the decay average, as for the attack.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param decay_time_ms Decay time in milliseconds, 0 disables the fast decay.
+ */
+void sa_set_decay_time(SA_Handle_t *const handle, float32_t decay_time_ms)
+{
+    float32_t decay = (decay_time_ms > 0.0f) ? sa_alpha(handle, decay_time_ms) : handle->release_alpha;
+
+    if (decay < handle->release_alpha)
+    {
+        decay = handle->release_alpha;
+    }
+
+    handle->decay_limit = SA_ATTACK_THRESHOLD * SA_ATTACK_THRESHOLD * decay / (2.0f - decay);
+    handle->decay_alpha = decay;
+}
+
+
+/**
+ * @brief Restarts the averages from the next result.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ */
+void sa_reset(SA_Handle_t *const handle)
+{
+    memset(handle->channel, 0, sizeof(handle->channel));
+    handle->primed = 0;
+}
+
+
+/**
+ * @brief Averages a new result and replaces its magnitude and cross spectrum by the averages.
+ *
+ * The averages start from the first result after sa_init() or sa_reset().
+ * In multi-tone mode every tone is averaged separately.
+ *
+ * @param handle Pointer to the SA_Handle_t structure.
+ * @param data Pointer to the MD_Data_t structure of the new result, overwritten with the averaged values.
+ */
+void sa_update(SA_Handle_t *const handle, MD_Data_t *const data)
+{
+    sa_average(handle, &handle->channel[0], &data->rx_signal_magnitude, &data->cross_real, &data->cross_imag,
+               data->tx_signal_magnitude);
+
+    for(size_t t = 0; (t < data->tone_count) && (t < MD_MAX_TONES); t++)
+    {
+        MD_ToneData_t *tone = &data->tones[t];
+
+        sa_average(handle, &handle->channel[t + 1], &tone->rx_signal_magnitude, &tone->cross_real, &tone->cross_imag,
+                   tone->tx_signal_magnitude);
+    }
+
+    handle->primed = 1;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file target_event.c
+ * @brief Implementation file for the target event detector.
+ *
+ * This file contains the onset, peak and release state machine. The release
+ * waits TE_RELEASE_MS without a detected frame, which bridges single frames
+ * that miss the threshold in the middle of a pass, so a pass gives one event
+ * instead of one per detected frame. Every frame costs a few additions, and
+ * a detected one a few multiplications more.
+ *
+ * The confidence is the product of two factors between 0 and 1: the detected
+ * time relative to TE_FULL_CONFIDENCE_MS, as a real target is seen over
+ * several frames while noise is not, and how closely the phases of the
+ * frames agree, as the phase of a real target does not change during a pass.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include "target_event.h"
+
+/** @brief Global handle for the event detector. */
+TE_Handle_t te_handle = {0};
+
+
+/**
+ * @brief Starts a new event with its first detected frame.
+ *
+ * @param handle Pointer to the TE_Handle_t structure.
+ * @param phase_difference Phase difference of the target in the frame in degrees.
+ */
+static void te_start(TE_Handle_t *const handle, int16_t phase_difference)
+{
+    handle->state = TE_ACTIVE;
+    handle->elapsed = 0;
+    handle->last_detected = 0;
+    handle->detected = 0;
+    handle->onset_phase = phase_difference;
+    handle->peak_magnitude = 0;
+    handle->weight_sum = 0;
+    handle->phase_sum = 0;
+    handle->phase_square_sum = 0;
+}
+
+
+/**
+ * @brief Adds a detected frame to the running event.
+ *
+ * @param handle Pointer to the TE_Handle_t structure.
+ * @param magnitude Magnitude of the target in the frame.
+ * @param phase_difference Phase difference of the target in the frame in degrees.
+ */
+static void te_accumulate(TE_Handle_t *const handle, float32_t magnitude, int16_t phase_difference)
+{
+    int32_t offset = (int32_t)phase_difference - handle->onset_phase;
+
+    /* Shortest way from the onset phase */
+    if (offset > 180)
+    {
+        offset -= 360;
+    }
+    else if (offset < -180)
+    {
+        offset += 360;
+    }
+
+    if (magnitude > handle->peak_magnitude)
+    {
+        handle->peak_magnitude = magnitude;
+    }
+
+    handle->weight_sum += magnitude;
+    handle->phase_sum += magnitude * (float32_t)offset;
+    handle->phase_square_sum += magnitude * (float32_t)offset * (float32_t)offset;
+    handle->last_detected = handle->elapsed;
+    handle->detected++;
+}
+
+
+/**
+ * @brief Ends the running event and fills the event structure.
+ *
+ * @param handle Pointer to the TE_Handle_t structure.
+ * @param event Pointer to the TE_Event_t structure that receives the event.
+ */
+static void te_finish(TE_Handle_t *const handle, TE_Event_t *const event)
+{
+    float32_t mean = 0, spread = 0, time_factor = 0, phase_factor = 0;
+    int32_t phase = 0;
+
+    if (handle->weight_sum > 0.0f)
+    {
+        mean = handle->phase_sum / handle->weight_sum;
+        spread = handle->phase_square_sum / handle->weight_sum - mean * mean;
+        spread = (spread > 0.0f) ? sqrtf(spread) : 0.0f;
+    }
+
+    phase = (int32_t)handle->onset_phase + (int32_t) lroundf(mean);
+    if (phase > 180)
+    {
+        phase -= 360;
+    }
+    else if (phase < -180)
+    {
+        phase += 360;
+    }
+
+    time_factor = ( (float32_t)handle->detected * handle->update_period_ms ) / TE_FULL_CONFIDENCE_MS;
+    time_factor = (time_factor > 1.0f) ? 1.0f : time_factor;
+    phase_factor = 1.0f - spread / TE_PHASE_SPREAD_LIMIT;
+    phase_factor = (phase_factor < 0.0f) ? 0.0f : phase_factor;
+
+    event->peak_magnitude = handle->peak_magnitude;
+    event->phase = (int16_t)phase;
+    event->duration_ms = (uint16_t)( (float32_t)handle->last_detected * handle->update_period_ms );
+    event->frames = (handle->detected > UINT16_MAX) ? UINT16_MAX : (uint16_t)handle->detected;
+    event->confidence = (uint8_t)( 100.0f * time_factor * phase_factor + 0.5f );
+
+    handle->state = TE_IDLE;
+}
+
+
+/**
+ * @brief Initializes the event detector in the idle state.
+ *
+ * @param handle Pointer to the TE_Handle_t structure.
+ * @param update_period_ms Time between two frames in milliseconds.
+ */
+void te_init(TE_Handle_t *const handle, float32_t update_period_ms)
+{
+    handle->update_period_ms = update_period_ms;
+    handle->release_frames = (uint32_t) ceilf(TE_RELEASE_MS / update_period_ms);
+    handle->max_frames = (uint32_t)(TE_MAX_DURATION_MS / update_period_ms);
+    handle->state = TE_IDLE;
+}
+
+
+/**
+ * @brief Advances the event detector by one frame.
+ *
+ * An event ends when the target was not detected for release_frames, or when
+ * it lasted max_frames, in which case the next detected frame starts a new
+ * event right away.
+ *
+ * @param handle Pointer to the TE_Handle_t structure.
+ * @param status Detection status of the frame.
+ * @param magnitude Magnitude of the target in the frame, used if it was detected.
+ * @param phase_difference Phase difference of the target in the frame in degrees, used if it was detected.
+ * @param event Pointer to the TE_Event_t structure that receives an ended event.
+ * @return TE_Status_t TE_EVENT if an event ended with this frame, TE_NO_EVENT otherwise.
+ */
+TE_Status_t te_update(TE_Handle_t *const handle, MD_DetectStatus_t status, float32_t magnitude,
+                      int16_t phase_difference, TE_Event_t *const event)
+{
+    if (handle->state == TE_IDLE)
+    {
+        if (status != TARGET_DETECTED)
+        {
+            return TE_NO_EVENT;
+        }
+
+        te_start(handle, phase_difference);
+    }
+    else
+    {
+        handle->elapsed++;
+    }
+
+    if (status == TARGET_DETECTED)
+    {
+        te_accumulate(handle, magnitude, phase_difference);
+    }
+
+    if ( (handle->elapsed - handle->last_detected >= handle->release_frames) || (handle->elapsed >= handle->max_frames) )
+    {
+        te_finish(handle, event);
+        return TE_EVENT;
+    }
+
+    return TE_NO_EVENT;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file target_tracker.c
+ * @brief Implementation file for the target tracker.
+ *
+ * This file contains the alpha-beta tracker of the target response. The
+ * velocity gain follows from the position gain with the closed-form
+ * steady-state Kalman solution, so no covariance has to be propagated. The
+ * position gain adapts to the motion: a steady-state Kalman filter has an
+ * innovation power of the measurement noise divided by 1 - alpha, so the
+ * measured innovation power gives the gain that matches the current motion
+ * of the response. The measurement noise is estimated from the second
+ * difference of consecutive measurements, which a smooth pass hardly
+ * changes, so the estimate does not depend on the gains it controls.
+ *
+ * The lowest gain is the one whose step response settles to TT_SETTLE_RATIO
+ * within TT_MAX_LATENCY_MS, found once by tt_init(), so the added latency
+ * never exceeds it. Every frame costs the same fixed number of operations:
+ * one sine and cosine, one square root for the gains, one for the magnitude
+ * and one arctangent, without any loop or allocation.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include "target_tracker.h"
+#include "fast_math.h"
+
+/** @brief Global handle for the target tracker. */
+TT_Handle_t tt_handle = {0};
+
+
+/**
+ * @brief Sets the position gain and the velocity gain that belongs to it.
+ *
+ * @param handle Pointer to the TT_Handle_t structure.
+ * @param alpha Position gain in the range 0..1.
+ */
+static void tt_gains(TT_Handle_t *const handle, float32_t alpha)
+{
+    float32_t r = sqrtf(1.0f - alpha);
+
+    handle->alpha = alpha;
+    handle->beta = 2.0f * (1.0f - r) * (1.0f - r);
+}
+
+
+/**
+ * @brief Returns whether the step response settles within the given number of frames.
+ *
+ * @param alpha Position gain.
+ * @param frames Number of frames.
+ * @return uint8_t 1 if the output reaches TT_SETTLE_RATIO within the frames, 0 otherwise.
+ */
+static uint8_t tt_settles(float32_t alpha, uint32_t frames)
+{
+    TT_Handle_t test = {0};
+    float32_t position = 0, velocity = 0;
+
+    tt_gains(&test, alpha);
+
+    for(uint32_t i = 0; i < frames; i++)
+    {
+        float32_t error = 1.0f - (position + velocity);
+
+        position += velocity + test.alpha * error;
+        velocity += test.beta * error;
+
+        if (position >= TT_SETTLE_RATIO)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Initializes the tracker without a track and derives the gain limits from the frame period.
+ *
+ * The lowest position gain is found by bisection, as the settling time only
+ * falls with a growing gain. The noise estimate is kept, it carries over
+ * from one pass to the next.
+ *
+ * @param handle Pointer to the TT_Handle_t structure.
+ * @param update_period_ms Time between two frames in milliseconds.
+ */
+void tt_init(TT_Handle_t *const handle, float32_t update_period_ms)
+{
+    const uint32_t latency_frames = (uint32_t)(TT_MAX_LATENCY_MS / update_period_ms);
+    float32_t low = 0, high = TT_MAX_ALPHA;
+
+    handle->update_period_ms = update_period_ms;
+    handle->coast_frames = (uint32_t) ceilf(TT_COAST_MS / update_period_ms);
+
+    if (tt_settles(high, latency_frames) == 0)
+    {
+        /* Even the largest gain is too slow for a latency this short, no smoothing is left */
+        low = high;
+    }
+    else
+    {
+        for(size_t i = 0; i < 32; i++)
+        {
+            float32_t middle = 0.5f * (low + high);
+
+            if (tt_settles(middle, latency_frames))
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle;
+            }
+        }
+        low = high;
+    }
+
+    handle->min_alpha = low;
+    handle->tracking = 0;
+    handle->history = 0;
+    handle->missed = 0;
+}
+
+
+/**
+ * @brief Advances the tracker by one frame.
+ *
+ * A detected frame starts a track with the largest gains, or corrects the
+ * running one. A frame without detection leaves the state as it is, as the
+ * velocity of the edge of a pass would run away over the frames that miss
+ * the threshold, and the track is dropped after TT_COAST_MS without a
+ * detection, so the next pass does not start from the previous target.
+ *
+ * @param handle Pointer to the TT_Handle_t structure.
+ * @param status Detection status of the frame.
+ * @param magnitude Pointer to the magnitude of the target in the frame, replaced by the smoothed one if it was detected.
+ * @param phase_difference Pointer to the phase difference in degrees, replaced by the smoothed one if it was detected.
+ * @return uint8_t 1 if the smoothed magnitude and phase are valid, 0 if no track is held.
+ */
+uint8_t tt_update(TT_Handle_t *const handle, MD_DetectStatus_t status, float32_t *const magnitude,
+                  int16_t *const phase_difference)
+{
+    float32_t angle = 0, real = 0, imag = 0;
+
+    if (status != TARGET_DETECTED)
+    {
+        if (handle->tracking)
+        {
+            handle->history = 0;
+
+            if (++handle->missed >= handle->coast_frames)
+            {
+                handle->tracking = 0;
+            }
+        }
+
+        return handle->tracking;
+    }
+
+    angle = (float32_t)(*phase_difference) * (PI / 180.0f);
+    real = *magnitude * cosf(angle);
+    imag = *magnitude * sinf(angle);
+
+    if (handle->tracking == 0)
+    {
+        handle->real = real;
+        handle->imag = imag;
+        handle->velocity_real = 0;
+        handle->velocity_imag = 0;
+        handle->innovation_power = 2.0f * handle->noise_power;
+        handle->frames = 1;
+        handle->history = 0;
+        handle->tracking = 1;
+        tt_gains(handle, TT_MAX_ALPHA);
+    }
+    else
+    {
+        float32_t predicted_real = handle->real + handle->velocity_real;
+        float32_t predicted_imag = handle->imag + handle->velocity_imag;
+        float32_t error_real = real - predicted_real;
+        float32_t error_imag = imag - predicted_imag;
+
+        float32_t alpha = TT_MAX_ALPHA;
+        float32_t frames = (float32_t)(++handle->frames);
+        float32_t start_alpha = 2.0f * (2.0f * frames - 1.0f) / ( frames * (frames + 1.0f) );
+
+        handle->innovation_power += TT_INNOVATION_WEIGHT *
+                                    (error_real * error_real + error_imag * error_imag - handle->innovation_power);
+
+        /* Gain of the steady-state Kalman filter whose innovation power is the measured one, both components */
+        if (handle->innovation_power > 0.0f)
+        {
+            alpha = 1.0f - 2.0f * TT_MOTION_MARGIN * handle->noise_power / handle->innovation_power;
+        }
+        /* A young track has no history to average yet, it starts as a least-squares line fit */
+        alpha = (alpha < start_alpha) ? start_alpha : alpha;
+        alpha = (alpha < handle->min_alpha) ? handle->min_alpha : alpha;
+        alpha = (alpha > TT_MAX_ALPHA) ? TT_MAX_ALPHA : alpha;
+        tt_gains(handle, alpha);
+
+        handle->real = predicted_real + handle->alpha * error_real;
+        handle->imag = predicted_imag + handle->alpha * error_imag;
+        handle->velocity_real += handle->beta * error_real;
+        handle->velocity_imag += handle->beta * error_imag;
+    }
+
+    /* The second difference of white noise has 6 times its variance per component */
+    if (handle->history == 2)
+    {
+        float32_t second_real = real - 2.0f * handle->last_real[0] + handle->last_real[1];
+        float32_t second_imag = imag - 2.0f * handle->last_imag[0] + handle->last_imag[1];
+        float32_t sample = (second_real * second_real + second_imag * second_imag) / 12.0f;
+
+        handle->noise_power += (handle->noise_power > 0.0f) ? TT_NOISE_WEIGHT * (sample - handle->noise_power) : sample;
+    }
+    else
+    {
+        handle->history++;
+    }
+
+    handle->last_real[1] = handle->last_real[0];
+    handle->last_imag[1] = handle->last_imag[0];
+    handle->last_real[0] = real;
+    handle->last_imag[0] = imag;
+    handle->missed = 0;
+
+    handle->magnitude = sqrtf(handle->real * handle->real + handle->imag * handle->imag);
+    handle->phase = fm_atan2f(handle->imag, handle->real) * (180.0f / PI);
+
+    *magnitude = handle->magnitude;
+    *phase_difference = (int16_t) lroundf(handle->phase);
+
+    return 1;
+}
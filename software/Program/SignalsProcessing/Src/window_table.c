@@ -0,0 +1,75 @@
+/**
+ * @file window_table.c
+ * @brief Implementation file for the window function tables.
+ *
+ * This file contains the generation of the window tables. All windows are
+ * periodic sums of cosines, w[n] = a0 - a1 cos(x) + a2 cos(2x) - ..., with
+ * x = 2*pi*n/N. The mean of such a window, its coherent gain, is exactly a0.
+ * The tables of one window are stored back to back from the shortest to the
+ * longest length, so the table of length N starts at offset N - FFT_PLAN_MIN_LEN.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <math.h>
+#include "window_table.h"
+
+/** @brief Maximum number of cosine terms of a window. */
+#define WIN_MAX_TERMS                      5
+
+/** @brief Cosine coefficients a0..a4 of every window, indexed by WIN_Type_t - 1. */
+static const float32_t WIN_COEFFS[WIN_COUNT - 1][WIN_MAX_TERMS] = {
+        {0.5f, 0.5f, 0.0f, 0.0f, 0.0f},                                  /* Hann */
+        {0.35875f, 0.48829f, 0.14128f, 0.01168f, 0.0f},                  /* Blackman-Harris */
+        {0.21557895f, 0.41663158f, 0.277263158f, 0.083578947f, 0.006947368f} /* Flat-top */
+};
+
+/** @brief Window tables of all windows except the rectangular one, in DTCM. */
+static float32_t win_tables[WIN_COUNT - 1][WIN_TABLE_LEN] WIN_DTCM;
+
+
+/**
+ * @brief Computes the window tables for all window functions and supported lengths.
+ *
+ * This function is called once at startup. The DTCM section is not
+ * initialized by the startup code, so the tables are only valid afterwards.
+ */
+void win_init(void)
+{
+    for(size_t w = 0; w < WIN_COUNT - 1; w++)
+    {
+        const float32_t *a = WIN_COEFFS[w];
+        float32_t *table = win_tables[w];
+
+        for(uint32_t len = FFT_PLAN_MIN_LEN; len <= FFT_PLAN_MAX_LEN; len <<= 1)
+        {
+            for(uint32_t n = 0; n < len; n++)
+            {
+                float32_t x = 2.0f * PI * (float32_t)n / (float32_t)len;
+                float32_t value = a[0] - a[1] * cosf(x) + a[2] * cosf(2.0f * x) - a[3] * cosf(3.0f * x) + a[4] * cosf(4.0f * x);
+
+                /* Divide by the coherent gain */
+                *table++ = value / a[0];
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Returns the coefficients of a window for the given FFT length.
+ *
+ * @param type Window function.
+ * @param len FFT length, a power of two between FFT_PLAN_MIN_LEN and FFT_PLAN_MAX_LEN.
+ * @return const float32_t* Coefficients, or NULL for the rectangular window or an unsupported length.
+ */
+const float32_t *win_get(WIN_Type_t type, uint16_t len)
+{
+    if( (type == WIN_RECTANGULAR) || (type >= WIN_COUNT) || (fft_plan_get(&fft_plan_cache, len) == NULL) )
+    {
+        return NULL;
+    }
+
+    return &win_tables[type - 1][len - FFT_PLAN_MIN_LEN];
+}
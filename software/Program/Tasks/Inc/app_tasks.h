@@ -4,7 +4,7 @@
  *
  * This file contains the declarations for tasks that handle signal processing,
  * metal detection, and audio output. It also declares external handles for
- * message queues and semaphores used in these tasks.
+ * the tasks, semaphores and mutexes used in these tasks.
  *
  * Created on: Jul 21, 2024
  * Author: Viktor
@@ -18,9 +18,21 @@
 
 #define AUDIO_DURATION 250								/*!< Duration for which the audio signal is produced when metal is detected, in milliseconds. */
 
+#define CHART_REFRESH_PERIOD 35							/*!< Period at which the GUI task adds new values to the chart, in milliseconds. */
 
-extern osMessageQueueId_t InputFlagQueueHandle; 		/*!< Handle for the message queue used for input flags */
+#define DETECTION_HOLD_TIME 1225						/*!< Time for which the GUI shows the last detected target, in milliseconds. */
+
+#define DIAG_REFRESH_PERIOD 500							/*!< Period at which the GUI task updates the timing statistics, in milliseconds. */
+
+#define UI_DETECTION_FLAG 0x0001U						/*!< Thread flag set on the GUI task when a target was detected */
+
+
+extern osThreadId_t SignalProcessingHandle; 			/*!< Handle for the signal processing task, woken up by the ADC interrupts */
+
+extern osThreadId_t lvHandlerHandle; 					/*!< Handle for the GUI task, woken up by the signal processing task */
 
 extern osSemaphoreId_t AudioSemaphoreHandle; 			/*!< Handle for the semaphore used for audio control */
 
+extern osMutexId_t LvMutexHandle; 						/*!< Handle for the mutex that must be held by every task calling LVGL */
+
 #endif /* TASKS_INC_APP_TASKS_H_ */
@@ -0,0 +1,94 @@
+/**
+ * @file meas_bus.h
+ * @brief Header file for the measurement bus between the application tasks.
+ *
+ * This file contains the declarations for the bus that publishes the result of
+ * every processed frame from the signal processing task to any number of
+ * subscribers, such as the GUI and the audio task. The writer never waits and
+ * the readers never take a lock. Every subscriber counts the results it did
+ * not see.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef TASKS_INC_MEAS_BUS_H_
+#define TASKS_INC_MEAS_BUS_H_
+
+#include <stdint.h>
+#include "metal_detecting.h"
+
+
+/**
+ * @brief Result of a read from the measurement bus.
+ */
+typedef enum
+{
+    MB_NEW = 0,                     /*!< A result the subscriber has not seen yet was read */
+    MB_NO_UPDATE                    /*!< Nothing was published since the last read */
+} MB_Status_t;
+
+
+/**
+ * @brief Result of one processed frame.
+ */
+typedef struct
+{
+    uint32_t frame;                 /*!< Sequence number of the frame the result was computed from */
+    MD_DetectStatus_t status;       /*!< Detection status of this frame */
+    uint32_t detections;            /*!< Number of frames with a detected target since start-up */
+    uint32_t events;                /*!< Number of passes over a target since start-up, see target_event.h */
+    uint32_t accepted;              /*!< Number of those events whose class the discrimination accepted */
+    int16_t phase_diff;             /*!< Magnitude-weighted mean phase difference of the last event */
+    uint8_t target_class;           /*!< Class of the last event, see DS_Class_t */
+    uint8_t confidence;             /*!< Confidence of the last event in percent */
+    uint16_t magnitude;             /*!< Peak magnitude of the last event above the ground balance or the background */
+    uint16_t duration_ms;           /*!< Duration of the last event in milliseconds */
+} MB_Measurement_t;
+
+
+/**
+ * @brief Handle structure for the measurement bus.
+ *
+ * The writer fills the slot that readers are not using and then advances the
+ * version, so a slot is only rewritten two publications after it was current.
+ * A reader therefore never waits for an unfinished write, even if it preempted
+ * the writer, and repeats its copy only if the writer ran in between.
+ */
+typedef struct
+{
+    MB_Measurement_t slots[2];      /*!< Current result in slots[version & 1], the next one in the other */
+    volatile uint32_t version;      /*!< Number of published results */
+} MB_Bus_t;
+
+
+/**
+ * @brief Read position of one subscriber.
+ */
+typedef struct
+{
+    uint32_t version;               /*!< Version of the last result read */
+    uint32_t received;              /*!< Number of results read */
+    uint32_t missed;                /*!< Number of results published but never read */
+} MB_Subscriber_t;
+
+
+extern MB_Bus_t meas_bus;           /*!< Global measurement bus written by the signal processing task */
+
+/**
+ * @brief Publishes the result of one frame, to be called by the single writer only.
+ * @param bus Pointer to the MB_Bus_t structure.
+ * @param measurement Pointer to the result to be published.
+ */
+void mb_publish(MB_Bus_t *const bus, const MB_Measurement_t *const measurement);
+
+/**
+ * @brief Reads the latest result without blocking.
+ * @param bus Pointer to the MB_Bus_t structure.
+ * @param subscriber Pointer to the MB_Subscriber_t structure of the reader.
+ * @param measurement Pointer to the MB_Measurement_t structure that receives the latest result.
+ * @return MB_Status_t MB_NEW if the result was not read by this subscriber before.
+ */
+MB_Status_t mb_read(const MB_Bus_t *const bus, MB_Subscriber_t *const subscriber, MB_Measurement_t *const measurement);
+
+#endif /* TASKS_INC_MEAS_BUS_H_ */
@@ -15,170 +15,637 @@
 #include "signal.h"
 #include "lvgl.h"
 #include "ui.h"
+#include "ui_callbacks.h"
 #include "app_signal.h"
 #include "metal_detecting.h"
+#include "iq_demod.h"
+#include "fft_plan.h"
+#include "load_kernel.h"
+#include "sliding_dft.h"
+#include "iq_stream.h"
+#include "sync_average.h"
+#include "ground_balance.h"
+#include "discrimination.h"
+#include "target_event.h"
+#include "target_tracker.h"
+#include "meas_bus.h"
+#include "deadline_monitor.h"
+#include "cycle_counter.h"
+#include "capture.h"
+#include "decimator.h"
 #include "main.h"
 
-/* Static variables to hold detection status, phase difference, and magnitude */
+#if TIME_DOMAIN_CHART_LEN > SIG_SNAPSHOT_LEN
+#error "The time domain chart needs more samples than sig_view_snapshot() keeps"
+#endif
+
+/* Static variables to hold the frame results and the read positions of the subscribers */
+
+static MB_Measurement_t frame_result = {0};    /*!< Result of the last frame, written by the signal processing task */
+static MB_Subscriber_t audio_subscriber = {0}; /*!< Read position of the audio task on the measurement bus */
+static MB_Subscriber_t ui_subscriber = {0};    /*!< Read position of the GUI task on the measurement bus */
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_STREAM
+static IQS_Reader_t detect_reader = {0};       /*!< Read position of the detection on the I/Q stream */
+#endif
 
-static MD_DetectStatus_t md_flag = NO_TARGET;  /*!< Metal detection flag */
-static int16_t phase_diff = 0;                 /*!< Phase difference between signals */
-static uint16_t magnitude = 0;                 /*!< Magnitude of the received signal */
 
 /**
  * @brief Task to produce audio when metal is detected.
  *
  * This task waits for the AudioSemaphoreHandle to be released,
  * then enables the audio amplifier for a specified duration to produce an audio signal.
+ * The amplifier stays on as long as the measurement bus reports new accepted
+ * target events within the duration, so every pass over a target gives one
+ * tone, and a notched out target none.
  *
  * @param argument: Task argument (unused).
  */
 void ProduceAudioTask(void *argument)
 {
+    MB_Measurement_t measurement = {0};
+    uint32_t accepted = 0;
+
     for(;;)
     {
         /* Wait for the semaphore to be released */
         osSemaphoreAcquire(AudioSemaphoreHandle, osWaitForever);
+        (void) mb_read(&meas_bus, &audio_subscriber, &measurement);
 
         /* Enable Audio Amplifier */
         HAL_GPIO_WritePin(AMP_SD_CNTRL_GPIO_Port, AMP_SD_CNTRL_Pin, SET);
 
         /* Delay to keep the amplifier on for the duration of the audio signal */
-        osDelay(AUDIO_DURATION);
+        do
+        {
+            accepted = measurement.accepted;
+            osDelay(AUDIO_DURATION);
+
+            /* Detections seen on the bus need no further trigger */
+            (void) osSemaphoreAcquire(AudioSemaphoreHandle, 0);
+            (void) mb_read(&meas_bus, &audio_subscriber, &measurement);
+        } while( measurement.accepted != accepted );
 
         /* Disable Audio Amplifier */
         HAL_GPIO_WritePin(AMP_SD_CNTRL_GPIO_Port, AMP_SD_CNTRL_Pin, RESET);
     }
 }
 
+/**
+ * @brief Runs the metal detection on one demodulation result.
+ *
+ * This function smooths the phase difference and magnitude of every detected
+ * frame with the target tracker, feeds them into the target event detector
+ * and publishes the result of the frame on the measurement bus.
+ * When a pass over a target ends, the event is classified by its mean phase,
+ * the audio semaphore is released only when the active discrimination preset
+ * accepts its class, and the GUI task is woken up. The peak magnitude, phase,
+ * duration and confidence of the last event stay in the result, and the
+ * event counter lets every subscriber tell whether a pass ended since its
+ * last read, even if it missed that frame.
+ *
+ * @param signal_data Pointer to the MD_Data_t structure holding the demodulation result.
+ * @param frame Sequence number of the frame the result was computed from.
+ */
+static void DetectTarget(const MD_Data_t *const signal_data, uint32_t frame)
+{
+    int16_t phase_difference = 0;
+    float32_t magnitude = 0;
+    TE_Event_t event = {0};
+
+    /* Detect metal and calculate phase difference if target is detected */
+    frame_result.frame = frame;
+    frame_result.status = md_detect(&md_handle, signal_data, &phase_difference);
+
+    if( frame_result.status == TARGET_DETECTED )
+    {
+        frame_result.detections++;
+    }
+
+    /* Smooth the phase difference and magnitude over the frames of the pass */
+    magnitude = md_handle.target_magnitude;
+    tt_update(&tt_handle, frame_result.status, &magnitude, &phase_difference);
+
+    /* Consolidate the frames of a pass into one event */
+    if( te_update(&te_handle, frame_result.status, magnitude, phase_difference, &event) != TE_EVENT )
+    {
+        mb_publish(&meas_bus, &frame_result);
+        return;
+    }
+
+    /* Update event counter, phase difference, magnitude and class */
+    frame_result.events++;
+    frame_result.phase_diff = event.phase;
+    frame_result.magnitude = (uint16_t) event.peak_magnitude;
+    frame_result.duration_ms = event.duration_ms;
+    frame_result.confidence = event.confidence;
+    frame_result.target_class = (uint8_t) ds_classify(&ds_handle, event.phase);
+
+    /* Release the audio semaphore to trigger audio output, unless the class is notched out */
+    if( ds_accept(&ds_handle, (DS_Class_t)frame_result.target_class) )
+    {
+        frame_result.accepted++;
+        osSemaphoreRelease(AudioSemaphoreHandle);
+    }
+
+    mb_publish(&meas_bus, &frame_result);
+
+    /* Wake up the GUI task to show the event without waiting for its next refresh */
+    osThreadFlagsSet(lvHandlerHandle, UI_DETECTION_FLAG);
+}
+
+/**
+ * @brief Captures the ground on request and removes it from one demodulation result.
+ *
+ * The motion detector restarts its background when a new ground balance
+ * takes effect, as the balanced vector jumps at that result.
+ *
+ * @param signal_data Pointer to the MD_Data_t structure holding the demodulation result.
+ */
+static void BalanceGround(MD_Data_t *const signal_data)
+{
+    if( gb_update(&gb_handle, signal_data) )
+    {
+        md_set_detector(&md_handle, md_handle.detector);
+    }
+}
+
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_SDFT
 /**
  * @brief Task to process signals and detect metal.
  *
- * This task waits for a flag from the input queue, processes the signal to
- * perform FFT and detect metal, and updates detection status and phase difference.
+ * This task is woken up by the capture tick whenever the DMA wrote a new
+ * sub-block, or a chunk with the decimating front-end, and runs the sliding
+ * DFT on every new sub-block, so a detection result is produced every
+ * SDFT_SUBBLOCK_LEN samples.
+ * Every result is averaged synchronously and ground balanced before the
+ * detection.
+ * The average only spans about one window of the sliding DFT, so the result
+ * keeps its sub-millisecond latency.
+ * The frames from the frame ring are only used to update the charts.
+ * The deadline monitor records the latency of every result from the moment
+ * the DMA wrote the last sample of its sub-block, which is found from the DMA
+ * position and the sample period, so a result that waits too long is seen as
+ * a miss.
+ * With the decimating front-end the samples appear a whole chunk at a time,
+ * so that moment is taken somewhat early and the latency overstated.
  *
  * @param argument: Task argument (unused).
  */
 void SignalProcessingTask(void *argument)
 {
-    uint8_t flag;
+    FR_Descriptor_t frame = {0};
+    uint8_t frame_ready = 0;
+    SIG_View_t view = {0};
     MD_Data_t signal_data = {0};
-    int16_t phase_difference = 0;
-    size_t main_freq = 0;
+    SDFT_Status_t status = SDFT_IDLE;
+    uint32_t start = 0, release = 0;
+    uint16_t write_index = 0, ready = 0;
+    const uint32_t sample_cycles = (uint32_t)( ( (uint64_t)SystemCoreClock * FP_TIM_PERIOD * FP_DECIMATION )
+                                               / FP_TIMER_CLOCK_HZ );
+
+    /* Start the sliding window at the current DMA position */
+    sdft_init(&sdft_handle, sig_get_write_index());
+
+    /* A result is averaged with the previous ones and detected every sub-block */
+    sa_init(&sa_handle, ( 1000.0f * (float32_t)SDFT_SUBBLOCK_LEN ) / FP_SAMPLE_RATE_HZ);
+    sa_set_time_constant(&sa_handle, ( 1000.0f * (float32_t)SDFT_WINDOW_LEN ) / FP_SAMPLE_RATE_HZ);
+    md_init(&md_handle, ( 1000.0f * (float32_t)SDFT_SUBBLOCK_LEN ) / FP_SAMPLE_RATE_HZ);
+    ds_init(&ds_handle);
+    gb_init(&gb_handle, ( 1000.0f * (float32_t)SDFT_SUBBLOCK_LEN ) / FP_SAMPLE_RATE_HZ);
+    te_init(&te_handle, ( 1000.0f * (float32_t)SDFT_SUBBLOCK_LEN ) / FP_SAMPLE_RATE_HZ);
+    tt_init(&tt_handle, ( 1000.0f * (float32_t)SDFT_SUBBLOCK_LEN ) / FP_SAMPLE_RATE_HZ);
+
+    /* The new sub-blocks must be processed before the next wake-up */
+    dm_init(&dm_handle, sample_cycles * SDFT_WAKE_LEN);
 
     for(;;)
     {
-        /* Wait for a message from the queue and get the flag */
-        osMessageQueueGet(InputFlagQueueHandle, (void *)&flag, 0, osWaitForever);
+        /* Sleep until the capture reports new sub-blocks, the timeout only covers a lost wake-up */
+        (void) osThreadFlagsWait(SDFT_THREAD_FLAG, osFlagsWaitAny, SDFT_POLL_PERIOD_MS);
+
+        /* Consume all complete sub-blocks */
+        do
+        {
+            start = cc_get();
+            write_index = sig_get_write_index();
+
+            /* The oldest unread sub-block was completed when the DMA wrote its last sample */
+            ready = (uint16_t)( (write_index + INPUT_BUFF_LEN - sdft_handle.read_index) % INPUT_BUFF_LEN );
+            release = start
+                      - (uint32_t)( (ready >= SDFT_SUBBLOCK_LEN) ? (ready - SDFT_SUBBLOCK_LEN) : 0 ) * sample_cycles;
+
+            status = sdft_update(&sdft_handle, &sig_handle, write_index, &signal_data);
+            if( status == SDFT_RESULT )
+            {
+                sa_update(&sa_handle, &signal_data);
+                BalanceGround(&signal_data);
+                DetectTarget(&signal_data, sdft_handle.updates);
+
+                dm_record(&dm_handle, release, start, cc_get());
+            }
+        } while( status != SDFT_IDLE );
+
+        /* The completed blocks are needed only by the charts, only the newest one is shown */
+        frame_ready = 0;
+        while( fr_pop(&sig_handle.frames, &frame) == FR_OK )
+        {
+            frame_ready = 1;
+        }
+
+        if( frame_ready && (sig_view_acquire(&sig_handle, &frame, &view) == SIG_OK) )
+        {
+            sig_view_snapshot(&sig_handle, &view);
+
+            if( ui_chart_domain == CHART_FREQ_DOMAIN )
+            {
+                sig_load_samples(&sig_handle, &view);
+                (void) sig_perform_fft(&sig_handle);
+                sig_update_polar(&sig_handle, 0, FREQ_DOMAIN_CHART_LEN);
+            }
+
+            (void) sig_view_release(&sig_handle, &view);
+        }
+    }
+}
+#else
+/**
+ * @brief Task to process signals and detect metal.
+ *
+ * This task waits for a frame from the frame ring, demodulates the signal with
+ * the selected engine, averages the result synchronously with the previous
+ * blocks, removes the ground to detect metal, and updates detection status
+ * and phase difference.
+ * With the I/Q engine the FFT is only run while the frequency domain chart
+ * is shown.
+ * Frames that queued up while the task was busy are processed back-to-back.
+ * The samples are processed in place in the DMA buffer through a view, and a
+ * result is discarded if the DMA overwrote the block before the view was
+ * released.
+ * With the stream engine every frame mixes the samples written so far into
+ * the I/Q stream instead, and the detection runs on every new I/Q sample, so
+ * its rate is SIG_IQ_STREAM_RATE_HZ whatever the block length.
+ * The blocks are then only used by the charts.
+ * The deadline monitor records the latency of every detection result.
+ *
+ * @param argument: Task argument (unused).
+ */
+void SignalProcessingTask(void *argument)
+{
+    FR_Descriptor_t frame = {0};
+    SIG_View_t view = {0};
+    MD_Data_t signal_data = {0};
+    uint32_t start = 0;
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_FFT
+    SIG_CrossSpectrum_t cross = {0};
+#endif
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_STREAM
+    IQS_Sample_t sample = {0};
+
+    /* A result is averaged with the previous ones and detected every I/Q sample */
+    const float32_t period_ms = 1000.0f / IQS_RATE_HZ;
+#else
+    /* A result is averaged with the previous ones and detected every block */
+    const float32_t period_ms = ( 1000.0f * (float32_t)BUFF_TO_DFT_LEN ) / FP_SAMPLE_RATE_HZ;
+#endif
+
+    /* Prepare the I/Q demodulator reference tables */
+    iq_init(&iq_handle);
+
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_STREAM
+    /* Start the I/Q stream at the current DMA position, the detection reads it from its first sample */
+    iqs_init(&iqs_handle, sig_get_write_index());
+    iqs_reader_init(&iqs_handle, &detect_reader);
+#endif
+
+    sa_init(&sa_handle, period_ms);
+    md_init(&md_handle, period_ms);
+    ds_init(&ds_handle);
+    gb_init(&gb_handle, period_ms);
+    te_init(&te_handle, period_ms);
+    tt_init(&tt_handle, period_ms);
 
+    /* A frame must be processed before the DMA completes the next block */
+    dm_init(&dm_handle, (uint32_t)( ( (uint64_t)SystemCoreClock * FP_TIM_PERIOD * FP_DECIMATION * BUFF_TO_DFT_LEN )
+                                    / FP_TIMER_CLOCK_HZ ));
+
+    for(;;)
+    {
+        /* Sleep until the ADC interrupts push a frame, unless one is already queued */
+        if( fr_pop(&sig_handle.frames, &frame) != FR_OK )
+        {
+            osThreadFlagsWait(FR_THREAD_FLAG, osFlagsWaitAny, osWaitForever);
+            continue;
+        }
+        start = cc_get();
+
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_STREAM
+        /* Continue the I/Q stream up to the current DMA position and detect on its new I/Q samples */
+        (void) iqs_update(&iqs_handle, &sig_handle, sig_get_write_index());
+        while( iqs_read(&iqs_handle, &detect_reader, &sample) == IQS_OK )
+        {
+            /* The stream restarted before this I/Q sample, so the motion detector restarts its background */
+            if( !sample.continuous )
+            {
+                md_set_detector(&md_handle, md_handle.detector);
+            }
+
+            iqs_to_data(&sample, &signal_data);
+            sa_update(&sa_handle, &signal_data);
+            BalanceGround(&signal_data);
+            DetectTarget(&signal_data, sample.sequence);
+        }
+#endif
+
+        /* Take the completed block, skip it if the DMA is already overwriting it */
+        if( sig_view_acquire(&sig_handle, &frame, &view) != SIG_OK )
+        {
+            continue;
+        }
+
+#if SIG_BENCHMARK_ENABLE
+        /* Measure both demodulation engines on the same block */
+        iq_benchmark(&iq_handle, &sig_handle, &view, &iq_benchmark_result);
+
+        /* Measure the per-frame savings of the FFT plan cache */
+        fft_plan_benchmark(&fft_plan_cache, sig_handle.fft_len, &fft_plan_benchmark_result);
+
+#if SIG_ARITHMETIC == SIG_ARITHMETIC_F32
+        /* Measure the polar conversion of the detector bin against all bins */
+        sig_load_samples(&sig_handle, &view);
+        (void) sig_perform_fft(&sig_handle);
+        sig_polar_benchmark(&sig_handle, &sig_polar_benchmark_result);
+#endif
+#endif
+
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_IQ
+        /* Demodulate the TX frequency components only */
+        if( sig_handle.tx_mode == SIG_TX_MULTI )
+        {
+            iq_demodulate_multi(&iq_handle, &view, &signal_data);
+        }
+        else
+        {
+            iq_demodulate(&iq_handle, &view, &signal_data);
+        }
+
+        /* The spectrum is needed only by the frequency domain chart */
+        if( ui_chart_domain == CHART_FREQ_DOMAIN )
+        {
+            sig_load_samples(&sig_handle, &view);
+            (void) sig_perform_fft(&sig_handle);
+            sig_update_polar(&sig_handle, 0, FREQ_DOMAIN_CHART_LEN);
+        }
+#elif SIG_DEMOD_ENGINE == SIG_DEMOD_STREAM
+        /* The detection already ran on the I/Q stream, the spectrum is needed only by the frequency domain chart */
+        if( ui_chart_domain == CHART_FREQ_DOMAIN )
+        {
+            sig_load_samples(&sig_handle, &view);
+            (void) sig_perform_fft(&sig_handle);
+            sig_update_polar(&sig_handle, 0, FREQ_DOMAIN_CHART_LEN);
+        }
+#else
         /* Load ADC samples into the signal handler */
-        sig_load_samples(&sig_handle, flag);
+        sig_load_samples(&sig_handle, &view);
+
+        /* Perform FFT, the TX frequency lies exactly on the bin given by the frequency plan */
+        (void) sig_perform_fft(&sig_handle);
 
-        /* Perform FFT and get the dominant frequency index */
-        main_freq = sig_perform_fft(&sig_handle);
+        /* The detector needs no polar form, only the chart does */
+        if( ui_chart_domain == CHART_FREQ_DOMAIN )
+        {
+            sig_update_polar(&sig_handle, 0, FREQ_DOMAIN_CHART_LEN);
+        }
 
-        /* Populate signal data structure with magnitude and phase values */
-        signal_data.rx_signal_magnitude = sig_handle.rx_coil_polar[main_freq].magnitude;
-        signal_data.rx_signal_phase = sig_handle.rx_coil_polar[main_freq].phase;
-        signal_data.tx_signal_phase = sig_handle.tx_coil_polar[main_freq].phase;
+        /* Populate signal data structure with the magnitude and the cross spectrum of the TX bin */
+        sig_cross_spectrum(&sig_handle, &cross);
+        signal_data.rx_signal_magnitude = cross.rx_magnitude;
+        signal_data.tx_signal_magnitude = cross.tx_magnitude;
+        signal_data.cross_real = cross.real_part;
+        signal_data.cross_imag = cross.imaginary_part;
+#endif
 
-        /* Detect metal and calculate phase difference if target is detected */
-        if( md_detect(&md_handle, &signal_data, &phase_difference) == TARGET_DETECTED )
+        /* Keep a copy for the time domain chart and hand the block back to the DMA */
+        sig_view_snapshot(&sig_handle, &view);
+        if( sig_view_release(&sig_handle, &view) == SIG_OK )
         {
-            /* Release the audio semaphore to trigger audio output */
-            osSemaphoreRelease(AudioSemaphoreHandle);
+#if SIG_DEMOD_ENGINE != SIG_DEMOD_STREAM
+            /* Average the TX components and remove the ground before the detector takes magnitude and phase */
+            sa_update(&sa_handle, &signal_data);
+            BalanceGround(&signal_data);
+            DetectTarget(&signal_data, view.sequence);
+#endif
 
-            /* Update detection flag, phase difference, and magnitude */
-            md_flag = TARGET_DETECTED;
-            phase_diff = phase_difference;
-            magnitude = sig_handle.rx_coil_polar[main_freq].magnitude - md_handle.gnd_balance;
+            /* Account the latency from the DMA completion of the block to the end of the detection */
+            dm_record(&dm_handle, frame.timestamp, start, cc_get());
         }
     }
 }
+#endif
+
+/**
+ * @brief Shows the timing statistics of the signal processing task on the diagnostics tab.
+ *
+ * The latency runs from the DMA completion of a block to the end of its
+ * detection, the load is the processing time relative to the deadline.
+ * The frames lost in the frame ring and the blocks overwritten by the DMA
+ * are shown as well, as they never reach the deadline monitor, and so are
+ * the largest frame ring depth, which must stay below the capture ring
+ * length minus 2, and the captured ground phase.
+ * With the stream engine the I/Q stream and the samples the detection lost
+ * on it are shown too.
+ */
+static void UpdateDiagnostics(void)
+{
+    DM_Stats_t stats = {0};
+    char buf[384];
+
+    dm_get_stats(&dm_handle, &stats);
+
+    lv_snprintf(buf, sizeof(buf),
+                "Deadline: %u us\n"
+                "Latency min/avg/max: %u / %u / %u us\n"
+                "Latency p%u: %u us\n"
+                "Processing: %u us, load %u %%\n"
+                "Deadline misses: %u of %u\n"
+                "Frames dropped: %u, overwritten: %u\n"
+                "Frame ring depth max: %u, %u blocks\n"
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_STREAM
+                "I/Q stream: %u Hz, %u samples, %u restarts, %u lost\n"
+#endif
+                "Ground phase: %d deg",
+                (unsigned)stats.period_us,
+                (unsigned)stats.min_us, (unsigned)stats.avg_us, (unsigned)stats.max_us,
+                (unsigned)DM_PERCENTILE, (unsigned)stats.p99_us,
+                (unsigned)stats.avg_busy_us, (unsigned)stats.load_percent,
+                (unsigned)stats.misses, (unsigned)stats.count,
+                (unsigned)sig_handle.frames.drops, (unsigned)(sig_handle.view_overruns + sig_handle.view_late),
+                (unsigned)sig_handle.frames.max_depth, (unsigned)SIG_CAPTURE_BLOCK_COUNT,
+#if SIG_DEMOD_ENGINE == SIG_DEMOD_STREAM
+                (unsigned)IQS_RATE_HZ, (unsigned)iqs_handle.write_index,
+                (unsigned)iqs_handle.restarts, (unsigned)detect_reader.lost,
+#endif
+                (int)gb_handle.ground_phase);
+
+    lv_label_set_text(ui_DiagLabel, buf);
+}
+
+/**
+ * @brief Shows the progress of a running ground capture on the ground balance button.
+ *
+ * The label is only rewritten when the progress changes, "Set" is shown
+ * when no capture runs.
+ */
+static void UpdateGroundBalance(void)
+{
+    static int16_t shown = -1;
+    int16_t progress = ( gb_handle.state == GB_CAPTURING ) ? (int16_t)gb_progress(&gb_handle) : -1;
+    char buf[8];
+
+    if( progress == shown )
+    {
+        return;
+    }
+    shown = progress;
+
+    if( progress < 0 )
+    {
+        lv_label_set_text(ui_GndBalanceBtnLabel, "Set");
+    }
+    else
+    {
+        lv_snprintf(buf, sizeof(buf), "%d%%", (int)progress);
+        lv_label_set_text(ui_GndBalanceBtnLabel, buf);
+    }
+}
 
 /**
  * @brief Task to handle LVGL GUI updates.
  *
  * This task updates the LVGL user interface with signal processing results,
- * including depth bar, phase arc, and charts for time and frequency domains.
+ * including depth bar, phase arc, the class mark on the notch strip, charts
+ * for time and frequency domains, the progress of a ground capture and the
+ * timing statistics on the diagnostics tab.
+ * Between two updates it sleeps until the next LVGL timer is due, the next
+ * chart refresh is due, or the signal processing task reports a target event,
+ * whichever comes first.
+ * LVGL is only called with LvMutexHandle held.
  *
  * @param argument: Task argument (unused).
  */
 void LvHandlerTask(void *argument)
 {
-    uint8_t refresh_delay = 0;
+    MB_Measurement_t measurement = {0};
+    uint32_t events = 0;
+    uint32_t now = osKernelGetTickCount();
+    uint32_t detection_time = now;
+    uint32_t chart_time = now;
+    uint32_t diag_time = now;
+    uint32_t sleep_time = 0;
+    uint8_t bars_set = 0;
 
     for(;;)
     {
-        /* Update LVGL bars and arcs if target is detected */
-        if( md_flag == TARGET_DETECTED )
+        osMutexAcquire(LvMutexHandle, osWaitForever);
+        now = osKernelGetTickCount();
+
+        /* Update LVGL bars and arcs if a pass over a target ended since the last refresh */
+        if( (mb_read(&meas_bus, &ui_subscriber, &measurement) == MB_NEW) && (measurement.events != events) )
         {
+            events = measurement.events;
+            detection_time = now;
+            bars_set = 1;
+
             /* Set value for depth bar */
-            lv_bar_set_value(ui_DepthBar, magnitude, LV_ANIM_OFF);
+            lv_bar_set_value(ui_DepthBar, measurement.magnitude, LV_ANIM_OFF);
 
             /* Trigger value change event for depth bar */
             lv_obj_send_event(ui_DepthBar, LV_EVENT_VALUE_CHANGED, NULL);
 
             /* Set value for phase arc */
-            lv_arc_set_value(ui_PhaseArc, phase_diff);
+            lv_arc_set_value(ui_PhaseArc, measurement.phase_diff);
 
             /* Trigger value change event for phase arc */
             lv_obj_send_event(ui_PhaseArc, LV_EVENT_VALUE_CHANGED, NULL);
 
-            /* Reset detection flag */
-            md_flag = NO_TARGET;
+            /* Mark the class of the target on the notch strip */
+            notch_strip_refresh((int8_t)measurement.target_class);
         }
-        else if( md_flag == NO_TARGET )
+        else if( bars_set && (now - detection_time >= DETECTION_HOLD_TIME) )
         {
-            /* Update bars and arcs if no target is detected and refresh delay is met */
-            if( refresh_delay >= 35 )
-            {
-                /* Reset value for depth bar */
-                lv_bar_set_value(ui_DepthBar, 0, LV_ANIM_OFF);
+            /* Reset value for depth bar */
+            lv_bar_set_value(ui_DepthBar, 0, LV_ANIM_OFF);
 
-                /* Trigger value change event for depth bar */
-                lv_obj_send_event(ui_DepthBar, LV_EVENT_VALUE_CHANGED, NULL);
+            /* Trigger value change event for depth bar */
+            lv_obj_send_event(ui_DepthBar, LV_EVENT_VALUE_CHANGED, NULL);
 
-                /* Reset value for phase arc */
-                lv_arc_set_value(ui_PhaseArc, 0);
+            /* Reset value for phase arc */
+            lv_arc_set_value(ui_PhaseArc, 0);
 
-                /* Trigger value change event for phase arc */
-                lv_obj_send_event(ui_PhaseArc, LV_EVENT_VALUE_CHANGED, NULL);
+            /* Trigger value change event for phase arc */
+            lv_obj_send_event(ui_PhaseArc, LV_EVENT_VALUE_CHANGED, NULL);
 
-                /* Reset refresh delay counter */
-                refresh_delay = 0;
-            }
-            else
-            {
-                /* Increment refresh delay counter */
-                refresh_delay++;
-            }
+            /* Remove the mark from the notch strip */
+            notch_strip_refresh(-1);
+
+            bars_set = 0;
         }
 
-        /* Update chart based on current domain */
-        if( ui_chart_domain == CHART_TIME_DOMAIN )
+        /* Update chart based on current domain once per refresh period */
+        if( now - chart_time >= CHART_REFRESH_PERIOD )
         {
-            /* Add time domain values to chart */
-            for(uint32_t i = 0; i < TIME_DOMAIN_CHART_LEN; i++)
+            chart_time = now;
+
+            if( ui_chart_domain == CHART_TIME_DOMAIN )
             {
-                lv_chart_set_next_value(ui_Chart, ui_Chart_series_1, sig_handle.input_sig[i].adc2);
-                lv_chart_set_next_value(ui_Chart, ui_Chart_series_2, sig_handle.input_sig[i].adc1);
+                /* Add time domain values to chart from the last complete snapshot */
+                const SIG_ADCRegister_t *snapshot = sig_handle.snapshot[sig_handle.snapshot_index];
+
+                for(uint32_t i = 0; i < TIME_DOMAIN_CHART_LEN; i++)
+                {
+                    lv_chart_set_next_value(ui_Chart, ui_Chart_series_1, snapshot[i].adc2 >> SIG_CODE_SHIFT);
+                    lv_chart_set_next_value(ui_Chart, ui_Chart_series_2, snapshot[i].adc1 >> SIG_CODE_SHIFT);
+                }
             }
-        }
-        else if( ui_chart_domain == CHART_FREQ_DOMAIN )
-        {
-            /* Add frequency domain values to chart */
-            for(uint32_t i = 0; i < FREQ_DOMAIN_CHART_LEN; i++)
+            else if( ui_chart_domain == CHART_FREQ_DOMAIN )
             {
-                lv_chart_set_next_value(ui_Chart, ui_Chart_series_1, sig_handle.rx_coil_polar[i].magnitude);
+                /* Add frequency domain values to chart */
+                for(uint32_t i = 0; i < FREQ_DOMAIN_CHART_LEN; i++)
+                {
+                    lv_chart_set_next_value(ui_Chart, ui_Chart_series_1, sig_handle.rx_coil_polar[i].magnitude);
+                }
             }
         }
 
-        /* Call the LVGL timer handler to process GUI events */
-        lv_timer_handler();
+        /* Follow a running ground capture */
+        UpdateGroundBalance();
+
+        /* Update the timing statistics, at the latest with the chart refresh that follows the period */
+        if( now - diag_time >= DIAG_REFRESH_PERIOD )
+        {
+            diag_time = now;
+            UpdateDiagnostics();
+        }
+
+        /* Call the LVGL timer handler to process GUI events, it returns the time until the next LVGL timer */
+        sleep_time = lv_timer_handler();
+        osMutexRelease(LvMutexHandle);
 
-        /* Delay for 35 ms before next iteration */
-        osDelay(35);
+        /* Do not sleep past the next chart refresh */
+        now = osKernelGetTickCount() - chart_time;
+        if( now >= CHART_REFRESH_PERIOD )
+        {
+            sleep_time = 0;
+        }
+        else if( sleep_time > CHART_REFRESH_PERIOD - now )
+        {
+            sleep_time = CHART_REFRESH_PERIOD - now;
+        }
+
+        /* Sleep until then, or until a target event is reported */
+        if( sleep_time > 0 )
+        {
+            (void) osThreadFlagsWait(UI_DETECTION_FLAG, osFlagsWaitAny, sleep_time);
+        }
     }
 }
 
@@ -0,0 +1,77 @@
+/**
+ * @file meas_bus.c
+ * @brief Implementation file for the measurement bus between the application tasks.
+ *
+ * This file contains the implementation of the measurement bus. It is a
+ * sequence lock over two slots: a plain sequence lock lets a reader spin while
+ * a write is in progress, which never ends when a reader of higher priority
+ * preempted the writer. The GUI and audio tasks both run below the signal
+ * processing task, so today a read can only be interrupted by a write, never
+ * the other way round. With two slots the current slot is never written, so
+ * a read only has to be repeated after the writer ran, and the bus stays
+ * wait-free if a subscriber of higher priority is added.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include "cmsis_compiler.h"
+#include "meas_bus.h"
+
+/** @brief Global measurement bus written by the signal processing task. */
+MB_Bus_t meas_bus = {0};
+
+
+/**
+ * @brief Publishes the result of one frame, to be called by the single writer only.
+ *
+ * @param bus Pointer to the MB_Bus_t structure.
+ * @param measurement Pointer to the result to be published.
+ */
+void mb_publish(MB_Bus_t *const bus, const MB_Measurement_t *const measurement)
+{
+    uint32_t version = bus->version + 1;
+
+    bus->slots[version & 1] = *measurement;
+
+    /* The slot must be complete before it becomes current */
+    __DMB();
+    bus->version = version;
+}
+
+
+/**
+ * @brief Reads the latest result without blocking.
+ *
+ * The copy is repeated if a new result was published during the copy,
+ * because the writer may already have started on the slot being copied. The
+ * number of results published between two reads is added to missed.
+ *
+ * @param bus Pointer to the MB_Bus_t structure.
+ * @param subscriber Pointer to the MB_Subscriber_t structure of the reader.
+ * @param measurement Pointer to the MB_Measurement_t structure that receives the latest result.
+ * @return MB_Status_t MB_NEW if the result was not read by this subscriber before.
+ */
+MB_Status_t mb_read(const MB_Bus_t *const bus, MB_Subscriber_t *const subscriber, MB_Measurement_t *const measurement)
+{
+    uint32_t version = 0;
+
+    do
+    {
+        version = bus->version;
+        __DMB();
+        *measurement = bus->slots[version & 1];
+        __DMB();
+    } while (bus->version != version);
+
+    if (version == subscriber->version)
+    {
+        return MB_NO_UPDATE;
+    }
+
+    subscriber->missed += version - subscriber->version - 1;
+    subscriber->received++;
+    subscriber->version = version;
+
+    return MB_NEW;
+}
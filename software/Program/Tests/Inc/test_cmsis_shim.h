@@ -0,0 +1,72 @@
+/**
+ * @file test_cmsis_shim.h
+ * @brief Portable replacements of the CMSIS intrinsics for the host tests.
+ *
+ * This file is force-included into the modules whose fast path is built on
+ * the Cortex-M intrinsics, so the host tests run that path instead of the
+ * portable fallback. The intrinsics of cmsis_gcc.h are inline assembly, so they
+ * are replaced here by C functions with the same results. The number of SIMD
+ * intrinsic calls is counted, which lets a test check that the fast path ran.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef TESTS_INC_TEST_CMSIS_SHIM_H_
+#define TESTS_INC_TEST_CMSIS_SHIM_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+extern uint32_t tcs_simd_calls;     /*!< Number of __SSUB16() and __SMUAD() calls since the start */
+
+
+/**
+ * @brief Saturates a value to the range of a signed half-word.
+ * @param value Value to saturate.
+ * @return int32_t Saturated value.
+ */
+static inline int32_t tcs_sat16(int32_t value)
+{
+    return (value > INT16_MAX) ? INT16_MAX : ( (value < INT16_MIN) ? INT16_MIN : value );
+}
+
+/**
+ * @brief Portable __SSUB16(), subtracts both signed half-words with saturation.
+ * @param op1 Minuend pair.
+ * @param op2 Subtrahend pair.
+ * @return uint32_t Packed differences.
+ */
+static inline uint32_t tcs_ssub16(uint32_t op1, uint32_t op2)
+{
+    int32_t low = tcs_sat16( (int32_t)(int16_t)op1 - (int32_t)(int16_t)op2 );
+    int32_t high = tcs_sat16( (int32_t)(int16_t)(op1 >> 16) - (int32_t)(int16_t)(op2 >> 16) );
+
+    tcs_simd_calls++;
+
+    return ( (uint32_t)high << 16 ) | ( (uint32_t)low & 0xFFFFU );
+}
+
+/**
+ * @brief Portable __SMUAD(), adds the products of both signed half-word pairs.
+ * @param op1 First pair.
+ * @param op2 Second pair.
+ * @return uint32_t Sum of the products.
+ */
+static inline uint32_t tcs_smuad(uint32_t op1, uint32_t op2)
+{
+    int32_t low = (int32_t)(int16_t)op1 * (int32_t)(int16_t)op2;
+    int32_t high = (int32_t)(int16_t)(op1 >> 16) * (int32_t)(int16_t)(op2 >> 16);
+
+    tcs_simd_calls++;
+
+    return (uint32_t)(low + high);
+}
+
+#define __SSUB16(op1, op2)                 tcs_ssub16( (op1), (op2) )
+#define __SMUAD(op1, op2)                  tcs_smuad( (op1), (op2) )
+
+/** @brief The host tests are single threaded, a compiler barrier is enough. */
+#define __DMB()                            __asm__ volatile ("" ::: "memory")
+
+#endif /* TESTS_INC_TEST_CMSIS_SHIM_H_ */
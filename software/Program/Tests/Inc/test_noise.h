@@ -0,0 +1,29 @@
+/**
+ * @file test_noise.h
+ * @brief Header file for the noise source of the host tests.
+ *
+ * This file contains the declarations for the pseudo-random noise shared by
+ * the host tests of the signal processing modules, so every test draws the
+ * same reproducible sequence from a given seed.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#ifndef TESTS_INC_TEST_NOISE_H_
+#define TESTS_INC_TEST_NOISE_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+/** @brief Seed used by the tests unless they need several independent sequences. */
+#define TN_DEFAULT_SEED                    12345UL
+
+/**
+ * @brief Returns a pseudo-random value with a zero mean and a variance of 1.
+ * @param state Pointer to the generator state, seeded by the caller.
+ * @return float32_t Random value.
+ */
+float32_t tn_gaussian(uint32_t *const state);
+
+#endif /* TESTS_INC_TEST_NOISE_H_ */
@@ -0,0 +1,34 @@
+/**
+ * @file test_noise.c
+ * @brief Implementation file for the noise source of the host tests.
+ *
+ * The values are the sum of four uniform values of a linear congruential
+ * generator, which is close enough to a normal distribution for the tests
+ * and gives the same sequence on every host.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include "test_noise.h"
+
+
+/**
+ * @brief Returns a pseudo-random value with a zero mean and a variance of 1.
+ *
+ * @param state Pointer to the generator state, seeded by the caller.
+ * @return float32_t Random value.
+ */
+float32_t tn_gaussian(uint32_t *const state)
+{
+    float32_t sum = 0;
+
+    for(size_t i = 0; i < 4; i++)
+    {
+        *state = *state * 1664525UL + 1013904223UL;
+        sum += (float32_t)(*state >> 8) / (float32_t)(1UL << 24) - 0.5f;
+    }
+
+    /* The variance of the sum of four uniform values is 4 / 12 */
+    return sum * 1.7320508f;
+}
@@ -0,0 +1,1168 @@
+/**
+ * @file test_signal_processing.c
+ * @brief Host tests of the signal processing modules.
+ *
+ * This file contains the tests that check the statistical properties of the
+ * signal processing stages, such as the noise reduction of the averager and
+ * of the tracker or the events of the motion detector, which the firmware
+ * cannot assert by itself, and the tests that check a fast implementation
+ * against a direct reference computed here. Every test feeds a handle
+ * initialized as in the signal processing task, either with generated noise
+ * or with the frames of a fixture in the Data folder, and checks its output
+ * against a bound. The program returns the number of failed checks.
+ *
+ * Created on: Oct 16, 2026
+ * Author: agent
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "test_noise.h"
+#include "sync_average.h"
+#include "metal_detecting.h"
+#include "target_tracker.h"
+#include "fft_plan.h"
+#include "packed_fft.h"
+#include "load_kernel.h"
+#include "sliding_dft.h"
+#include "decimator.h"
+#include "iq_stream.h"
+#include "test_cmsis_shim.h"
+
+/** @brief Frame period of the FFT engine in milliseconds, 1024 samples at 150 kHz. */
+#define TEST_BLOCK_PERIOD_MS               ( 1000.0f * 1024.0f / 150000.0f )
+
+/** @brief Frame period of the sliding DFT engine in milliseconds, 32 samples at 150 kHz. */
+#define TEST_SUBBLOCK_PERIOD_MS            ( 1000.0f * 32.0f / 150000.0f )
+
+/** @brief Length of the noise fed to the averager by test_sa_snr(), in time constants. */
+#define TEST_SA_TIME_CONSTANTS             400.0f
+
+/** @brief Shortfall of the measured SNR gain from the theoretical one that is still accepted, in dB. */
+#define TEST_SA_GAIN_MARGIN_DB             1.0f
+
+/** @brief Number of target passes in the sweeps of test_md_motion(). */
+#define TEST_MD_PASSES                     4
+
+/** @brief Largest error of the split spectra, relative to the largest bin, in parts per million. */
+#define TEST_PFFT_MAX_ERROR_PPM            1.0f
+
+/** @brief Number of input words of test_lk_convert(), enough for every start offset and tail length. */
+#define TEST_LK_SRC_LEN                    64
+
+/** @brief Number of sub-blocks fed to the sliding DFT by test_sdft_drift(). */
+#define TEST_SDFT_UPDATES                  1000000UL
+
+/** @brief Number of sub-blocks between two comparisons with the direct correlation in test_sdft_drift(). */
+#define TEST_SDFT_CHECK_PERIOD             65536UL
+
+/** @brief Number of raw samples per channel fed to the decimator by test_dec_process(). */
+#define TEST_DEC_RAW_LEN                   ( 2048 * SIG_DECIMATION )
+
+/** @brief Number of output samples over which test_dec_gain() measures a tone, a whole number of periods. */
+#define TEST_DEC_GAIN_LEN                  4096
+
+/** @brief Number of output samples skipped by test_dec_gain() until the filter has settled. */
+#define TEST_DEC_SETTLE_LEN                64
+
+/** @brief Amplitude of the test tones of test_dec_gain() in ADC codes. */
+#define TEST_DEC_TONE_AMPLITUDE            2000.0
+
+/** @brief Number of ADC samples fed to the I/Q stream by test_iqs_rate(), not a whole number of I/Q samples. */
+#define TEST_IQS_SAMPLES                   ( 1000000UL + 77UL )
+
+/** @brief Amplitudes of the TX and RX tones fed to the I/Q stream, relative to the DC offset. */
+#define TEST_IQS_TX_AMPLITUDE              0.7
+#define TEST_IQS_RX_AMPLITUDE              0.3
+
+/** @brief Phase of the RX tone against the TX tone fed to the I/Q stream, in radians. */
+#define TEST_IQS_PHASE                     0.7
+
+/** @brief Largest magnitude error of the I/Q samples of a clean tone, in parts per million. */
+#define TEST_IQS_MAX_ERROR_PPM             1000.0f
+
+/** @brief Largest phase error of the I/Q samples of a clean tone, in milliradians. */
+#define TEST_IQS_MAX_PHASE_MRAD            1.0f
+
+/** @brief Number of blocks fed to the I/Q stream by test_iqs_readers(). */
+#define TEST_IQS_BLOCKS                    1000
+
+/** @brief Number of blocks between two reads of the slow reader of test_iqs_readers(), more than the ring holds. */
+#define TEST_IQS_SLOW_PERIOD               ( ( 3 * IQS_RING_LEN * IQS_DECIMATION ) / ( 2 * BUFF_TO_DFT_LEN ) )
+
+/** @brief Number of failed checks. */
+static uint32_t test_failures = 0;
+
+/** @brief Number of intrinsic calls counted by test_cmsis_shim.h. */
+uint32_t tcs_simd_calls = 0;
+
+
+/**
+ * @brief Prints the result of a check and counts it if it failed.
+ *
+ * @param passed Non-zero if the check passed.
+ * @param name Name of the check.
+ * @param value Measured value.
+ * @param limit Bound the value was checked against.
+ */
+static void test_check(int passed, const char *name, float32_t value, float32_t limit)
+{
+    printf("%s %s: %.2f (limit %.2f)\n", passed ? "PASS" : "FAIL", name, (double)value, (double)limit);
+
+    if (!passed)
+    {
+        test_failures++;
+    }
+}
+
+
+/**
+ * @brief Measures the SNR gain of the averager on noisy results of a constant target.
+ *
+ * The averager is fed TEST_SA_TIME_CONSTANTS time constants of results whose RX component carries white
+ * noise with an SNR of 10 dB. The averages and the noise estimate start at
+ * their true values, so no settling time has to be skipped. The gain
+ * compares the power of the error of the cross spectrum before and after the
+ * averaging, and must come close to the (2 - alpha) / alpha of the time
+ * constant, so the fast attack and decay must not shorten the average of the
+ * noise.
+ *
+ * @param update_period_ms Time between two results in milliseconds.
+ */
+static void test_sa_snr(float32_t update_period_ms)
+{
+    const float32_t rx_real = 300.0f, rx_imag = 200.0f, tx_real = 1000.0f;
+    const float32_t sigma = sqrtf( (rx_real * rx_real + rx_imag * rx_imag) / 20.0f );
+    const uint32_t frames = (uint32_t)( TEST_SA_TIME_CONSTANTS * SA_TIME_CONSTANT_MS / update_period_ms );
+    SA_Handle_t handle = {0};
+    MD_Data_t data = {0};
+    uint32_t state = TN_DEFAULT_SEED;
+    float64_t input_error = 0, output_error = 0;
+    float32_t gain = 0, expected = 0;
+
+    sa_init(&handle, update_period_ms);
+    expected = 10.0f * log10f( (2.0f - handle.release_alpha) / handle.release_alpha );
+
+    /* The cross spectrum of the target without noise */
+    handle.channel[0].cross_real = rx_real * tx_real;
+    handle.channel[0].cross_imag = rx_imag * tx_real;
+    handle.channel[0].attack_real = rx_real * tx_real;
+    handle.channel[0].attack_imag = rx_imag * tx_real;
+    handle.channel[0].decay_real = rx_real * tx_real;
+    handle.channel[0].decay_imag = rx_imag * tx_real;
+    handle.channel[0].noise_power = 2.0f * sigma * sigma * tx_real * tx_real;
+    handle.channel[0].tx_magnitude = tx_real;
+    handle.primed = 1;
+
+    for(uint32_t i = 0; i < frames; i++)
+    {
+        float32_t real = rx_real + sigma * tn_gaussian(&state);
+        float32_t imag = rx_imag + sigma * tn_gaussian(&state);
+        float32_t error_real = 0, error_imag = 0;
+
+        data.cross_real = real * tx_real;
+        data.cross_imag = imag * tx_real;
+        data.tx_signal_magnitude = tx_real;
+        data.tone_count = 0;
+
+        error_real = real - rx_real;
+        error_imag = imag - rx_imag;
+        input_error += error_real * error_real + error_imag * error_imag;
+
+        sa_update(&handle, &data);
+
+        error_real = data.cross_real / tx_real - rx_real;
+        error_imag = data.cross_imag / tx_real - rx_imag;
+        output_error += error_real * error_real + error_imag * error_imag;
+    }
+
+    gain = (output_error > 0.0) ? (float32_t)( 10.0 * log10(input_error / output_error) ) : 0.0f;
+    printf("sa_snr at %.3f ms: expected %.2f dB\n", (double)update_period_ms, (double)expected);
+    test_check(gain >= expected - TEST_SA_GAIN_MARGIN_DB, "sa_snr gain dB", gain, expected - TEST_SA_GAIN_MARGIN_DB);
+}
+
+
+/**
+ * @brief Measures how long the averager holds a target that has left.
+ *
+ * A target ten times the noise stands for twice the time constant and then
+ * leaves. The averaged magnitude must fall below half of the target within
+ * twice the decay time, instead of the time constant of the slow average.
+ *
+ * @param update_period_ms Time between two results in milliseconds.
+ */
+static void test_sa_decay(float32_t update_period_ms)
+{
+    const float32_t target = 100.0f, sigma = 10.0f, tx_real = 1000.0f;
+    const uint32_t on_frames = (uint32_t)( 2.0f * SA_TIME_CONSTANT_MS / update_period_ms );
+    const float32_t limit_ms = 2.0f * SA_DECAY_TIME_MS;
+    SA_Handle_t handle = {0};
+    MD_Data_t data = {0};
+    uint32_t state = TN_DEFAULT_SEED;
+    float32_t release_ms = -1.0f;
+
+    sa_init(&handle, update_period_ms);
+
+    for(uint32_t i = 0; (i < 2 * on_frames) && (release_ms < 0.0f); i++)
+    {
+        float32_t real = ( (i < on_frames) ? target : 0.0f ) + sigma * tn_gaussian(&state);
+        float32_t imag = sigma * tn_gaussian(&state);
+
+        data.cross_real = real * tx_real;
+        data.cross_imag = imag * tx_real;
+        data.tx_signal_magnitude = tx_real;
+        data.tone_count = 0;
+
+        sa_update(&handle, &data);
+
+        if ( (i >= on_frames) && (data.rx_signal_magnitude < 0.5f * target) )
+        {
+            release_ms = (float32_t)(i - on_frames + 1) * update_period_ms;
+        }
+    }
+
+    printf("sa_decay at %.3f ms\n", (double)update_period_ms);
+    test_check( (release_ms >= 0.0f) && (release_ms <= limit_ms), "sa_decay release ms", release_ms, limit_ms);
+}
+
+
+/**
+ * @brief Counts the detection events of the motion detector on sweeps over a drifting ground.
+ *
+ * The motion detector with its default cutoff is fed TEST_MD_PASSES passes
+ * of a target over ground whose vector drifts by several times the
+ * sensitivity during the test. The passes get slower one after the other,
+ * from a half width of 0.1 s to 0.4 s, and carry white noise of a tenth of
+ * the sensitivity. The sensitivity is fixed to 10 and the target peaks at
+ * three times it. A detection event is a frame that detects a target after
+ * a frame that did not, and every pass must give exactly one.
+ *
+ * @param update_period_ms Time between two frames in milliseconds.
+ */
+static void test_md_motion(float32_t update_period_ms)
+{
+    const float32_t sensitivity = 10.0f, tx_magnitude = 1000.0f;
+    const float32_t pass_period_s = 3.0f;
+    const float32_t period_s = update_period_ms / 1000.0f;
+    const uint32_t frames = (uint32_t)( (float32_t)TEST_MD_PASSES * pass_period_s / period_s );
+    MD_Handle_t handle = {0};
+    MD_Data_t data = {0};
+    MD_DetectStatus_t status = NO_TARGET, previous = NO_TARGET;
+    uint32_t state = TN_DEFAULT_SEED;
+    uint32_t events = 0;
+    int16_t phase = 0;
+
+    md_init(&handle, update_period_ms);
+    handle.sensitivity = sensitivity;
+    md_set_detector(&handle, MD_DETECTOR_MOTION);
+
+    for(uint32_t i = 0; i < frames; i++)
+    {
+        float32_t t = (float32_t)i * period_s;
+        uint32_t pass = (uint32_t)(t / pass_period_s);
+        float32_t width = 0.1f * (float32_t)(pass + 1);
+        float32_t x = ( t - ( (float32_t)pass + 0.5f ) * pass_period_s ) / width;
+        float32_t target = 3.0f * sensitivity * expf(-x * x);
+        float32_t real = 0, imag = 0;
+
+        /* Ground drifting by 4 times the sensitivity over the test, target at 60 degrees */
+        real = 50.0f + 4.0f * sensitivity * t / ( (float32_t)TEST_MD_PASSES * pass_period_s ) + 0.5f * target;
+        imag = 20.0f + 0.866f * target;
+        real += 0.1f * sensitivity * tn_gaussian(&state);
+        imag += 0.1f * sensitivity * tn_gaussian(&state);
+
+        data.rx_signal_magnitude = sqrtf(real * real + imag * imag);
+        data.tx_signal_magnitude = tx_magnitude;
+        data.cross_real = real * tx_magnitude;
+        data.cross_imag = imag * tx_magnitude;
+
+        status = md_detect(&handle, &data, &phase);
+        if ( (status == TARGET_DETECTED) && (previous == NO_TARGET) )
+        {
+            events++;
+        }
+        previous = status;
+    }
+
+    printf("md_motion at %.3f ms\n", (double)update_period_ms);
+    test_check(events == TEST_MD_PASSES, "md_motion events", (float32_t)events, (float32_t)TEST_MD_PASSES);
+}
+
+
+/**
+ * @brief Returns the noise reduction of an alpha-beta filter in steady state, in dB.
+ *
+ * The velocity gain is the one the tracker pairs with alpha. The filtered
+ * position of white measurement noise has the variance of the noise times
+ * (2 * alpha^2 + 2 * beta - 3 * alpha * beta) / (alpha * (4 - 2 * alpha - beta)).
+ *
+ * @param alpha Position gain in the range 0..1.
+ * @return float32_t Ratio of the measurement noise power to the filtered noise power in dB.
+ */
+static float32_t test_tt_noise_gain(float32_t alpha)
+{
+    float64_t r = sqrt(1.0 - alpha);
+    float64_t beta = 2.0 * (1.0 - r) * (1.0 - r);
+    float64_t ratio = (2.0 * alpha * alpha + 2.0 * beta - 3.0 * alpha * beta) / ( alpha * (4.0 - 2.0 * alpha - beta) );
+
+    return (float32_t)( -10.0 * log10(ratio) );
+}
+
+
+/**
+ * @brief Measures the variance reduction of the tracker on the target passes of the fixture.
+ *
+ * The tracker follows the detected frames of Data/target_passes.csv, whose
+ * true magnitude and phase are known. The power of the phase and magnitude
+ * errors from the true values is compared before and after the tracker, so
+ * the lag of the tracker counts against it.
+ *
+ * The bounds come from the noise model of the tracker, not from the fixture.
+ * Its position gain always lies between the latency limit min_alpha and
+ * TT_MAX_ALPHA, so the reduction of the measurement noise lies between the
+ * steady-state reductions of these two gains, 0.72 dB and 8.6 dB at the
+ * frame period of the FFT engine. Both the phase and the magnitude error are
+ * projections of the noise of the two components, so the same bounds apply
+ * to both. Below the lower bound the tracker would add error, above the
+ * upper one it would smooth more than its latency allows.
+ */
+static void test_tt_variance(void)
+{
+    FILE *file = fopen(TEST_DATA_DIR "/target_passes.csv", "r");
+    TT_Handle_t handle = {0};
+    char line[128];
+    uint32_t frames = 0;
+    float64_t raw_phase_power = 0, raw_magnitude_power = 0;
+    float64_t phase_power = 0, magnitude_power = 0;
+    float32_t phase_gain = 0, magnitude_gain = 0;
+    float32_t min_gain = 0, max_gain = 0;
+
+    if (file == NULL)
+    {
+        test_check(0, "tt_variance fixture " TEST_DATA_DIR "/target_passes.csv", 0.0f, 0.0f);
+        return;
+    }
+
+    tt_init(&handle, TEST_BLOCK_PERIOD_MS);
+    min_gain = test_tt_noise_gain(TT_MAX_ALPHA);
+    max_gain = test_tt_noise_gain(handle.min_alpha);
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        int detected = 0, phase = 0;
+        float32_t magnitude = 0, target = 0, target_phase = 0;
+        float32_t smoothed_magnitude = 0;
+        int16_t smoothed_phase = 0;
+        MD_DetectStatus_t status = NO_TARGET;
+
+        /* Comments and the column names do not parse */
+        if (sscanf(line, "%d,%f,%d,%f,%f", &detected, &magnitude, &phase, &target, &target_phase) != 5)
+        {
+            continue;
+        }
+
+        frames++;
+        status = detected ? TARGET_DETECTED : NO_TARGET;
+        smoothed_magnitude = magnitude;
+        smoothed_phase = (int16_t)phase;
+
+        if ( tt_update(&handle, status, &smoothed_magnitude, &smoothed_phase) && (status == TARGET_DETECTED) )
+        {
+            raw_phase_power += ( (float32_t)phase - target_phase ) * ( (float32_t)phase - target_phase );
+            raw_magnitude_power += (magnitude - target) * (magnitude - target);
+            phase_power += ( (float32_t)smoothed_phase - target_phase ) * ( (float32_t)smoothed_phase - target_phase );
+            magnitude_power += (smoothed_magnitude - target) * (smoothed_magnitude - target);
+        }
+    }
+
+    fclose(file);
+
+    if ( (phase_power > 0.0) && (magnitude_power > 0.0) )
+    {
+        phase_gain = (float32_t)( 10.0 * log10(raw_phase_power / phase_power) );
+        magnitude_gain = (float32_t)( 10.0 * log10(raw_magnitude_power / magnitude_power) );
+    }
+
+    printf("tt_variance on %u frames\n", (unsigned)frames);
+    test_check(phase_gain >= min_gain, "tt_variance phase gain dB, lower bound", phase_gain, min_gain);
+    test_check(phase_gain <= max_gain, "tt_variance phase gain dB, upper bound", phase_gain, max_gain);
+    test_check(magnitude_gain >= min_gain, "tt_variance magnitude gain dB, lower bound", magnitude_gain, min_gain);
+    test_check(magnitude_gain <= max_gain, "tt_variance magnitude gain dB, upper bound", magnitude_gain, max_gain);
+}
+
+
+/**
+ * @brief Computes the DFT of a real signal in the layout of arm_rfft_fast_f32().
+ *
+ * @param x Real signal of len samples.
+ * @param len Transform length, even.
+ * @param spectrum len / 2 interleaved complex values, bin 0 holding DC and Nyquist.
+ */
+static void test_real_dft(const float64_t *x, size_t len, float64_t *spectrum)
+{
+    for(size_t k = 0; k < len / 2; k++)
+    {
+        float64_t real = 0, imag = 0;
+
+        for(size_t n = 0; n < len; n++)
+        {
+            float64_t angle = 2.0 * M_PI * (float64_t)( (k * n) % len ) / (float64_t)len;
+
+            real += x[n] * cos(angle);
+            imag -= x[n] * sin(angle);
+        }
+
+        spectrum[2 * k] = real;
+        spectrum[2 * k + 1] = imag;
+    }
+
+    /* The Nyquist bin is real and goes into the imaginary part of bin 0 */
+    spectrum[1] = 0;
+    for(size_t n = 0; n < len; n++)
+    {
+        spectrum[1] += (n & 1) ? -x[n] : x[n];
+    }
+}
+
+
+/**
+ * @brief Checks the split of the packed transform against a direct DFT of both signals.
+ *
+ * For every length of the FFT plan cache, TX and RX carry an offset, a tone,
+ * a Nyquist component and noise, so no bin is left empty. The spectrum of
+ * z = tx + j * rx is computed with a direct DFT and rounded to float, as
+ * arm_cfft_f32() would return it, and split with pfft_split(). Every bin,
+ * DC and Nyquist included, must match the direct DFT of the signal alone
+ * within TEST_PFFT_MAX_ERROR_PPM of the largest bin.
+ */
+static void test_pfft_split(void)
+{
+    static float64_t tx[FFT_PLAN_MAX_LEN], rx[FFT_PLAN_MAX_LEN];
+    static float64_t tx_ref[FFT_PLAN_MAX_LEN], rx_ref[FFT_PLAN_MAX_LEN];
+    static float32_t packed[2 * FFT_PLAN_MAX_LEN];
+    static float32_t tx_out[FFT_PLAN_MAX_LEN], rx_out[FFT_PLAN_MAX_LEN];
+    uint32_t state = TN_DEFAULT_SEED;
+    float32_t worst = 0, worst_edge = 0;
+
+    for(size_t len = FFT_PLAN_MIN_LEN; len <= FFT_PLAN_MAX_LEN; len *= 2)
+    {
+        float64_t peak = 0;
+
+        for(size_t n = 0; n < len; n++)
+        {
+            float64_t angle = 2.0 * M_PI * (float64_t)( (5 * n) % len ) / (float64_t)len;
+            float64_t nyquist = (n & 1) ? -1.0 : 1.0;
+
+            tx[n] = 1000.0 + 1500.0 * cos(angle + 0.3) + 200.0 * nyquist + 50.0 * tn_gaussian(&state);
+            rx[n] = -300.0 + 800.0 * sin(angle - 1.1) - 150.0 * nyquist + 50.0 * tn_gaussian(&state);
+        }
+
+        /* Spectrum of z = tx + j * rx */
+        for(size_t k = 0; k < len; k++)
+        {
+            float64_t real = 0, imag = 0;
+
+            for(size_t n = 0; n < len; n++)
+            {
+                float64_t angle = 2.0 * M_PI * (float64_t)( (k * n) % len ) / (float64_t)len;
+
+                real += tx[n] * cos(angle) + rx[n] * sin(angle);
+                imag += rx[n] * cos(angle) - tx[n] * sin(angle);
+            }
+
+            packed[2 * k] = (float32_t)real;
+            packed[2 * k + 1] = (float32_t)imag;
+        }
+
+        pfft_split(packed, len, tx_out, rx_out);
+        test_real_dft(tx, len, tx_ref);
+        test_real_dft(rx, len, rx_ref);
+
+        for(size_t i = 0; i < len; i++)
+        {
+            peak = (fabs(tx_ref[i]) > peak) ? fabs(tx_ref[i]) : peak;
+            peak = (fabs(rx_ref[i]) > peak) ? fabs(rx_ref[i]) : peak;
+        }
+
+        for(size_t i = 0; i < len; i++)
+        {
+            float32_t tx_error = (float32_t)( 1e6 * fabs(tx_out[i] - tx_ref[i]) / peak );
+            float32_t rx_error = (float32_t)( 1e6 * fabs(rx_out[i] - rx_ref[i]) / peak );
+            float32_t error = (tx_error > rx_error) ? tx_error : rx_error;
+
+            worst = (error > worst) ? error : worst;
+
+            /* DC in the real and Nyquist in the imaginary part of bin 0 */
+            if (i < 2)
+            {
+                worst_edge = (error > worst_edge) ? error : worst_edge;
+            }
+        }
+    }
+
+    test_check(worst_edge <= TEST_PFFT_MAX_ERROR_PPM, "pfft_split DC and Nyquist error ppm", worst_edge,
+               TEST_PFFT_MAX_ERROR_PPM);
+    test_check(worst <= TEST_PFFT_MAX_ERROR_PPM, "pfft_split bin error ppm", worst, TEST_PFFT_MAX_ERROR_PPM);
+}
+
+
+/**
+ * @brief Checks the fast sample conversion against the reference implementation.
+ *
+ * load_kernel.c is built with the DSP extension and the portable intrinsics of
+ * test_cmsis_shim.h, so lk_convert() runs its unrolled fast path. Both
+ * implementations convert the same random ADC words, extreme codes included,
+ * for every start offset within one iteration of the unrolled loop and every
+ * tail length, with and without a window, into separate (stride 1) and
+ * interleaved (stride 2) outputs. Every output value must match exactly, and
+ * the values past the end of the output must not be touched.
+ */
+static void test_lk_convert(void)
+{
+    static const uint16_t dc_offsets[] = {0, 2048, 4095};
+    static uint32_t src[TEST_LK_SRC_LEN];
+    static float32_t window[TEST_LK_SRC_LEN];
+    static float32_t out_ref[2 * TEST_LK_SRC_LEN + 2], out_fast[2 * TEST_LK_SRC_LEN + 2];
+    uint32_t state = TN_DEFAULT_SEED;
+    uint32_t mismatches = 0;
+    uint32_t simd_calls = tcs_simd_calls;
+
+    for(size_t i = 0; i < TEST_LK_SRC_LEN; i++)
+    {
+        state = state * 1664525UL + 1013904223UL;
+        src[i] = ( (state >> 4) & 0x0FFF0FFFUL );
+        window[i] = 0.5f + 0.25f * tn_gaussian(&state);
+    }
+    src[1] = 0x0FFF0000UL;
+    src[2] = 0x00000FFFUL;
+
+    for(size_t d = 0; d < sizeof(dc_offsets) / sizeof(dc_offsets[0]); d++)
+    {
+        for(size_t start = 0; start < LK_UNROLL; start++)
+        {
+            for(size_t len = TEST_LK_SRC_LEN - 2 * LK_UNROLL; len <= TEST_LK_SRC_LEN - start; len++)
+            {
+                for(size_t stride = 1; stride <= 2; stride++)
+                {
+                    for(size_t windowed = 0; windowed <= 1; windowed++)
+                    {
+                        /* RX follows TX in the same buffer, interleaved or one block later */
+                        size_t rx_offset = (stride == 2) ? 1 : len;
+                        LK_Params_t params = {&src[start], out_ref, &out_ref[rx_offset], stride,
+                                              windowed ? &window[start] : NULL, dc_offsets[d], len};
+
+                        for(size_t i = 0; i < 2 * TEST_LK_SRC_LEN + 2; i++)
+                        {
+                            out_ref[i] = -1e9f;
+                            out_fast[i] = -1e9f;
+                        }
+
+                        lk_convert_ref(&params);
+                        params.tx_out = out_fast;
+                        params.rx_out = &out_fast[rx_offset];
+                        lk_convert(&params);
+
+                        for(size_t i = 0; i < 2 * TEST_LK_SRC_LEN + 2; i++)
+                        {
+                            mismatches += (out_ref[i] != out_fast[i]) || ( (i >= 2 * len) && (out_fast[i] != -1e9f) );
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    test_check(tcs_simd_calls != simd_calls, "lk_convert fast path calls", (float32_t)(tcs_simd_calls - simd_calls),
+               1.0f);
+    test_check(mismatches == 0, "lk_convert mismatches", (float32_t)mismatches, 0.0f);
+}
+
+
+/**
+ * @brief Fills a reference table the way sdft_init() documents it, in Q14.
+ *
+ * @param ref_cos In-phase reference, cos(2*pi*n/L).
+ * @param ref_sin Quadrature reference, -sin(2*pi*n/L).
+ */
+static void test_sdft_reference(int32_t *ref_cos, int32_t *ref_sin)
+{
+    for(size_t i = 0; i < SDFT_REF_TABLE_LEN; i++)
+    {
+        float64_t angle = 2.0 * M_PI * (float64_t)i / (float64_t)SDFT_REF_TABLE_LEN;
+
+        ref_cos[i] = (int32_t)lround(cos(angle) * (float64_t)(1 << SDFT_REF_FRAC_BITS));
+        ref_sin[i] = (int32_t)lround(-sin(angle) * (float64_t)(1 << SDFT_REF_FRAC_BITS));
+    }
+}
+
+
+/**
+ * @brief Replays TEST_SDFT_UPDATES sub-blocks through the sliding DFT and checks that its sums never drift.
+ *
+ * The input ring is filled one sub-block at a time with random ADC codes over
+ * the whole range, as the DMA would, and sdft_update() is called after every
+ * sub-block. Every TEST_SDFT_CHECK_PERIOD updates and at the end, the four
+ * running sums are compared with a direct correlation of the last
+ * SDFT_WINDOW_LEN samples, kept by the test itself. Both must be equal.
+ */
+static void test_sdft_drift(void)
+{
+    static SIG_Handle_t sig;
+    static SDFT_Handle_t sdft;
+    static int16_t tx_window[SDFT_WINDOW_LEN], rx_window[SDFT_WINDOW_LEN];
+    int32_t ref_cos[SDFT_REF_TABLE_LEN], ref_sin[SDFT_REF_TABLE_LEN];
+    const uint16_t code_max = (uint16_t)( (1U << SIG_ADC_BITS) - 1U );
+    uint32_t state = TN_DEFAULT_SEED;
+    MD_Data_t data = {0};
+    uint32_t results = 0;
+    int64_t drift = 0;
+    uint64_t n = 0;
+    uint16_t write_index = 0;
+
+    test_sdft_reference(ref_cos, ref_sin);
+    sig.dc_offset = (uint16_t)( 1U << (SIG_ADC_BITS - 1) );
+    sdft_init(&sdft, write_index);
+
+    for(uint32_t update = 1; update <= TEST_SDFT_UPDATES; update++)
+    {
+        for(size_t i = 0; i < SDFT_SUBBLOCK_LEN; i++, n++)
+        {
+            SIG_ADCRegister_t *sample = &sig.input_sig[write_index + i];
+
+            state = state * 1664525UL + 1013904223UL;
+            sample->adc1 = (uint16_t)( (state >> 8) & code_max );
+            sample->adc2 = (uint16_t)( (state >> 20) & code_max );
+
+            /* Full scale codes now and then */
+            if ( (state & 0xFFU) == 0U )
+            {
+                sample->adc1 = code_max;
+                sample->adc2 = 0;
+            }
+
+            tx_window[n % SDFT_WINDOW_LEN] = (int16_t)( (int32_t)sample->adc1 - sig.dc_offset );
+            rx_window[n % SDFT_WINDOW_LEN] = (int16_t)( (int32_t)sample->adc2 - sig.dc_offset );
+        }
+        write_index = (uint16_t)( (write_index + SDFT_SUBBLOCK_LEN) % INPUT_BUFF_LEN );
+
+        results += (sdft_update(&sdft, &sig, write_index, &data) == SDFT_RESULT);
+
+        if ( ( (update % TEST_SDFT_CHECK_PERIOD) == 0 ) || (update == TEST_SDFT_UPDATES) )
+        {
+            int64_t sums[4] = {0};
+
+            for(uint64_t m = n - SDFT_WINDOW_LEN; m < n; m++)
+            {
+                size_t h = m % SDFT_WINDOW_LEN;
+                size_t k = m % SDFT_REF_TABLE_LEN;
+
+                sums[0] += (int64_t)tx_window[h] * ref_cos[k];
+                sums[1] += (int64_t)tx_window[h] * ref_sin[k];
+                sums[2] += (int64_t)rx_window[h] * ref_cos[k];
+                sums[3] += (int64_t)rx_window[h] * ref_sin[k];
+            }
+
+            sums[0] -= sdft.tx_real;
+            sums[1] -= sdft.tx_imag;
+            sums[2] -= sdft.rx_real;
+            sums[3] -= sdft.rx_imag;
+
+            for(size_t i = 0; i < 4; i++)
+            {
+                int64_t diff = (sums[i] < 0) ? -sums[i] : sums[i];
+
+                drift = (diff > drift) ? diff : drift;
+            }
+        }
+    }
+
+    test_check(results == TEST_SDFT_UPDATES - SDFT_WINDOW_LEN / SDFT_SUBBLOCK_LEN + 1, "sdft_drift results",
+               (float32_t)results, (float32_t)(TEST_SDFT_UPDATES - SDFT_WINDOW_LEN / SDFT_SUBBLOCK_LEN + 1));
+    test_check(drift == 0, "sdft_drift largest sum error", (float32_t)drift, 0.0f);
+}
+
+
+/**
+ * @brief Measures the latency of the sliding DFT from a step of the input to the first result that shows it.
+ *
+ * The input is at the DC offset until the window is full, then a TX frequency
+ * tone starts. The ring is written one sample at a time and sdft_update() is
+ * called after every sample, as if the task polled continuously. The latency
+ * is the number of samples from the step, the step sample included, to the
+ * first result with a non-zero RX magnitude. The step is moved over every
+ * position within a sub-block, and the worst latency must not exceed one
+ * sub-block.
+ */
+static void test_sdft_latency(void)
+{
+    static SIG_Handle_t sig;
+    static SDFT_Handle_t sdft;
+    uint32_t worst = 0;
+
+    sig.dc_offset = (uint16_t)( 1U << (SIG_ADC_BITS - 1) );
+
+    for(size_t offset = 0; offset < SDFT_SUBBLOCK_LEN; offset++)
+    {
+        const size_t step = SDFT_WINDOW_LEN + offset;
+        uint32_t latency = 0;
+        uint16_t write_index = 0;
+        MD_Data_t data = {0};
+
+        sdft_init(&sdft, write_index);
+
+        for(size_t n = 0; (latency == 0) && (n < step + 2 * SDFT_SUBBLOCK_LEN); n++)
+        {
+            float64_t angle = 2.0 * M_PI * (float64_t)(n % SDFT_REF_TABLE_LEN) / (float64_t)SDFT_REF_TABLE_LEN;
+            uint16_t code = sig.dc_offset;
+
+            if (n >= step)
+            {
+                code = (uint16_t)( sig.dc_offset + lround(0.5 * sig.dc_offset * cos(angle)) );
+            }
+
+            sig.input_sig[write_index].adc1 = code;
+            sig.input_sig[write_index].adc2 = code;
+            write_index = (uint16_t)( (write_index + 1) % INPUT_BUFF_LEN );
+
+            if ( (sdft_update(&sdft, &sig, write_index, &data) == SDFT_RESULT) && (data.rx_signal_magnitude > 0.0f) )
+            {
+                latency = (uint32_t)(n + 1 - step);
+            }
+        }
+
+        /* A step that never shows counts as an infinite latency */
+        worst = (latency == 0) ? UINT32_MAX : ( (latency > worst) ? latency : worst );
+    }
+
+    test_check(worst <= SDFT_SUBBLOCK_LEN, "sdft_latency samples", (float32_t)worst, (float32_t)SDFT_SUBBLOCK_LEN);
+}
+
+
+/**
+ * @brief Decimates the raw samples with a direct convolution, the reference of dec_process().
+ *
+ * Every intermediate sample is the convolution of the raw samples with the
+ * impulse response of the whole CIC filter, the DEC_CIC_ORDER-fold
+ * convolution of a DEC_CIC_RATIO long box, and every output sample the plain
+ * FIR convolution of the intermediate samples, so the reference shares no code
+ * with the recursive and polyphase implementation. The rounding and the
+ * limits of the output codes are the documented ones.
+ *
+ * @param taps FIR coefficients of the decimator, DEC_FIR_LEN values in Q15.
+ * @param src Raw samples, ADC1 in the low and ADC2 in the high half-word.
+ * @param dst Output samples in the same format, len / SIG_DECIMATION words.
+ * @param len Number of raw samples, a multiple of SIG_DECIMATION.
+ */
+static void test_dec_reference(const int16_t *taps, const uint32_t *src, uint32_t *dst, size_t len)
+{
+    const size_t response_len = DEC_CIC_ORDER * (DEC_CIC_RATIO - 1) + 1;
+    const uint32_t shift = DEC_CIC_GAIN_BITS + DEC_COEFF_FRAC_BITS - DEC_EXTRA_BITS;
+    int64_t response[DEC_CIC_ORDER * (DEC_CIC_RATIO - 1) + 1] = {1};
+
+    /* Impulse response of the CIC filter by repeated convolution with a box */
+    for(size_t s = 0; s < DEC_CIC_ORDER; s++)
+    {
+        for(size_t n = response_len; n-- > 0; )
+        {
+            int64_t sum = 0;
+
+            for(size_t r = 0; (r < DEC_CIC_RATIO) && (r <= n); r++)
+            {
+                sum += response[n - r];
+            }
+
+            response[n] = sum;
+        }
+    }
+
+    for(size_t p = 0; p < len / SIG_DECIMATION; p++)
+    {
+        dst[p] = 0;
+
+        for(uint32_t c = 0; c < 2; c++)
+        {
+            int64_t acc = 0, code = 0;
+
+            /* Output p follows intermediate sample 2p + 1, which follows raw sample (2p + 2) * DEC_CIC_RATIO - 1 */
+            for(size_t k = 0; (k < DEC_FIR_LEN) && (k <= 2 * p + 1); k++)
+            {
+                size_t last = (2 * p + 2 - k) * DEC_CIC_RATIO - 1;
+                int64_t sample = 0;
+
+                for(size_t j = 0; (j < response_len) && (j <= last); j++)
+                {
+                    sample += response[j] * (int64_t)( (src[last - j] >> (16 * c)) & 0xFFFFU );
+                }
+
+                acc += (int64_t)taps[k] * sample;
+            }
+
+            code = ( acc + ( (int64_t)1 << (shift - 1) ) ) >> shift;
+            code = (code < 0) ? 0 : ( (code > DEC_OUTPUT_MAX) ? DEC_OUTPUT_MAX : code );
+            dst[p] |= (uint32_t)code << (16 * c);
+        }
+    }
+}
+
+
+/**
+ * @brief Checks dec_process() against the direct convolution across block boundaries.
+ *
+ * The raw stream holds random codes on both channels, and full scale steps
+ * that drive the output into its limits. It is decimated once by the
+ * reference and once by dec_process() in blocks of changing sizes, from one
+ * output sample to a few hundred, so the filter state is carried over
+ * every kind of boundary. Every output word must be identical.
+ */
+static void test_dec_process(void)
+{
+    static const size_t block_outputs[] = {1, 2, 3, 15, 64, 255, 7, 128};
+    static DEC_Handle_t dec;
+    static uint32_t src[TEST_DEC_RAW_LEN];
+    static uint32_t out_ref[TEST_DEC_RAW_LEN / SIG_DECIMATION], out_fast[TEST_DEC_RAW_LEN / SIG_DECIMATION];
+    uint32_t state = TN_DEFAULT_SEED;
+    uint32_t mismatches = 0;
+    size_t done = 0;
+
+    for(size_t n = 0; n < TEST_DEC_RAW_LEN; n++)
+    {
+        state = state * 1664525UL + 1013904223UL;
+        src[n] = (state >> 4) & 0x0FFF0FFFUL;
+
+        /* Full scale steps on both channels in the second quarter */
+        if ( (n >= TEST_DEC_RAW_LEN / 4) && (n < TEST_DEC_RAW_LEN / 2) )
+        {
+            src[n] = ( (n / 64) & 1 ) ? 0x0FFF0000UL : 0x00000FFFUL;
+        }
+    }
+
+    dec_init(&dec);
+    test_dec_reference(dec.taps, src, out_ref, TEST_DEC_RAW_LEN);
+
+    for(size_t b = 0; done < TEST_DEC_RAW_LEN; b++)
+    {
+        size_t len = block_outputs[b % (sizeof(block_outputs) / sizeof(block_outputs[0]))] * SIG_DECIMATION;
+
+        len = (len > TEST_DEC_RAW_LEN - done) ? (TEST_DEC_RAW_LEN - done) : len;
+        dec_process(&dec, &src[done], &out_fast[done / SIG_DECIMATION], len);
+        done += len;
+    }
+
+    for(size_t p = 0; p < TEST_DEC_RAW_LEN / SIG_DECIMATION; p++)
+    {
+        mismatches += (out_ref[p] != out_fast[p]);
+    }
+
+    test_check(mismatches == 0, "dec_process mismatches", (float32_t)mismatches, 0.0f);
+}
+
+
+/**
+ * @brief Measures the gain of the decimator for a tone, in dB.
+ *
+ * The tone is fed on both channels around the middle code, with a whole
+ * number of periods in TEST_DEC_GAIN_LEN output samples at the frequency it
+ * aliases to. Its amplitude is taken from the DFT bin of that frequency
+ * after the filter has settled, so the DC offset does not contribute.
+ *
+ * @param dec Pointer to a DEC_Handle_t structure, initialized here.
+ * @param frequency Tone frequency relative to the output rate, below SIG_DECIMATION / 2.
+ * @return float32_t Gain relative to the input amplitude times 2^DEC_EXTRA_BITS.
+ */
+static float32_t test_dec_tone_gain(DEC_Handle_t *const dec, float32_t frequency)
+{
+    static uint32_t src[(TEST_DEC_GAIN_LEN + TEST_DEC_SETTLE_LEN) * SIG_DECIMATION];
+    static uint32_t out[TEST_DEC_GAIN_LEN + TEST_DEC_SETTLE_LEN];
+    const size_t raw_len = sizeof(src) / sizeof(src[0]);
+    size_t bin = (size_t)lround(frequency * TEST_DEC_GAIN_LEN);
+    size_t alias = bin % TEST_DEC_GAIN_LEN;
+    float64_t real = 0, imag = 0;
+
+    alias = (alias > TEST_DEC_GAIN_LEN / 2) ? (TEST_DEC_GAIN_LEN - alias) : alias;
+
+    for(size_t n = 0; n < raw_len; n++)
+    {
+        float64_t angle = 2.0 * M_PI * (float64_t)( (bin * n) % (TEST_DEC_GAIN_LEN * SIG_DECIMATION) )
+                          / (float64_t)(TEST_DEC_GAIN_LEN * SIG_DECIMATION);
+        uint32_t code = (uint32_t)lround(2048.0 + TEST_DEC_TONE_AMPLITUDE * cos(angle));
+
+        src[n] = code | (code << 16);
+    }
+
+    dec_init(dec);
+    dec_process(dec, src, out, raw_len);
+
+    for(size_t p = 0; p < TEST_DEC_GAIN_LEN; p++)
+    {
+        float64_t angle = 2.0 * M_PI * (float64_t)( (alias * p) % TEST_DEC_GAIN_LEN ) / (float64_t)TEST_DEC_GAIN_LEN;
+        float64_t y = (float64_t)(out[TEST_DEC_SETTLE_LEN + p] & 0xFFFFU);
+
+        real += y * cos(angle);
+        imag -= y * sin(angle);
+    }
+
+    return (float32_t)( 20.0 * log10( 2.0 * sqrt(real * real + imag * imag) / TEST_DEC_GAIN_LEN
+                                      / (TEST_DEC_TONE_AMPLITUDE * (1 << DEC_EXTRA_BITS)) ) );
+}
+
+
+/**
+ * @brief Checks the passband and stopband gain of the decimator against the bounds of decimator.h.
+ *
+ * Tones are swept over the passband up to DEC_PASS_EDGE, over the stopband
+ * from DEC_STOP_EDGE up to the raw Nyquist frequency, and within the
+ * stopband over the frequencies that alias into the passband. The stopband
+ * tones lie between the points of the grid, so none of them aliases onto
+ * DC or the output Nyquist frequency.
+ */
+static void test_dec_gain(void)
+{
+    static DEC_Handle_t dec;
+    float32_t pass_worst = 0, stop_worst = -200.0f, alias_worst = -200.0f;
+
+    for(float32_t f = 0.01f; f <= DEC_PASS_EDGE + 1e-4f; f += 0.01f)
+    {
+        float32_t gain = fabsf(test_dec_tone_gain(&dec, f));
+
+        pass_worst = (gain > pass_worst) ? gain : pass_worst;
+    }
+
+    for(float32_t f = DEC_STOP_EDGE + 0.005f; f < 0.5f * SIG_DECIMATION; f += 0.01f)
+    {
+        float32_t gain = test_dec_tone_gain(&dec, f);
+        float32_t offset = fabsf(f - roundf(f));
+
+        stop_worst = (gain > stop_worst) ? gain : stop_worst;
+        if (offset <= DEC_PASS_EDGE)
+        {
+            alias_worst = (gain > alias_worst) ? gain : alias_worst;
+        }
+    }
+
+    test_check(pass_worst <= DEC_PASS_RIPPLE_DB, "dec_gain passband deviation dB", pass_worst, DEC_PASS_RIPPLE_DB);
+    test_check(stop_worst <= -DEC_STOP_ATTENUATION_DB, "dec_gain stopband dB", stop_worst, -DEC_STOP_ATTENUATION_DB);
+    test_check(alias_worst <= -DEC_ALIAS_ATTENUATION_DB, "dec_gain aliases into the passband dB", alias_worst,
+               -DEC_ALIAS_ATTENUATION_DB);
+}
+
+
+/**
+ * @brief Writes the TX and RX test tones into the input ring, as the DMA would.
+ *
+ * Both tones are at the TX frequency, the RX tone lags by TEST_IQS_PHASE.
+ * The phase follows the number of samples written, which matches the input
+ * buffer index as long as the writing started at index 0.
+ *
+ * @param sig Pointer to the SIG_Handle_t structure holding the input ring and the DC offset.
+ * @param write_index DMA write index, advanced by count.
+ * @param written Number of samples written so far, advanced by count.
+ * @param count Number of samples to write.
+ */
+static void test_iqs_write(SIG_Handle_t *const sig, uint16_t *const write_index, uint64_t *const written, size_t count)
+{
+    for(size_t i = 0; i < count; i++, (*written)++)
+    {
+        float64_t angle = 2.0 * M_PI * (float64_t)(*written % IQS_REF_TABLE_LEN) / (float64_t)IQS_REF_TABLE_LEN;
+
+        long tx = lround(TEST_IQS_TX_AMPLITUDE * sig->dc_offset * cos(angle));
+        long rx = lround(TEST_IQS_RX_AMPLITUDE * sig->dc_offset * cos(angle - TEST_IQS_PHASE));
+
+        sig->input_sig[*write_index].adc1 = (uint16_t)( sig->dc_offset + tx );
+        sig->input_sig[*write_index].adc2 = (uint16_t)( sig->dc_offset + rx );
+        *write_index = (uint16_t)( (*write_index + 1) % INPUT_BUFF_LEN );
+    }
+}
+
+
+/**
+ * @brief Checks the output rate of the I/Q stream and its I/Q samples of a clean tone.
+ *
+ * TEST_IQS_SAMPLES samples are written in chunks of random length up to one
+ * block, and iqs_update() is called after every chunk. The stream must
+ * produce one I/Q sample per IQS_DECIMATION samples whatever the chunks,
+ * and its sample period must be within half a multi-tone period of the one
+ * of SIG_IQ_STREAM_RATE_HZ. Every I/Q sample must carry the amplitudes of
+ * both tones, halved by the mixing and in 12-bit codes, and their phase
+ * difference.
+ */
+static void test_iqs_rate(void)
+{
+    static SIG_Handle_t sig;
+    static IQS_Handle_t iqs;
+    const float32_t requested_period = 1.0f / (float32_t)SIG_IQ_STREAM_RATE_HZ;
+    const float32_t period = (float32_t)IQS_DECIMATION / FP_SAMPLE_RATE_HZ;
+    const float32_t tx_expected = (float32_t)( 0.5 * TEST_IQS_TX_AMPLITUDE * (1 << (SIG_ADC_BITS - 1)) )
+                                  / (float32_t)(1 << SIG_CODE_SHIFT);
+    const float32_t rx_expected = (float32_t)( 0.5 * TEST_IQS_RX_AMPLITUDE * (1 << (SIG_ADC_BITS - 1)) )
+                                  / (float32_t)(1 << SIG_CODE_SHIFT);
+    uint32_t state = TN_DEFAULT_SEED;
+    IQS_Reader_t reader = {0};
+    IQS_Sample_t sample = {0};
+    MD_Data_t data = {0};
+    uint32_t produced = 0, broken = 0;
+    float32_t magnitude_error = 0, phase_error = 0;
+    uint64_t written = 0;
+    uint16_t write_index = 0;
+
+    sig.dc_offset = (uint16_t)( 1U << (SIG_ADC_BITS - 1) );
+    iqs_init(&iqs, write_index);
+    iqs_reader_init(&iqs, &reader);
+
+    while (written < TEST_IQS_SAMPLES)
+    {
+        size_t count = 0;
+
+        state = state * 1664525UL + 1013904223UL;
+        count = 1 + (size_t)( (state >> 8) % BUFF_TO_DFT_LEN );
+        count = (count > TEST_IQS_SAMPLES - written) ? (size_t)(TEST_IQS_SAMPLES - written) : count;
+
+        test_iqs_write(&sig, &write_index, &written, count);
+        produced += iqs_update(&iqs, &sig, write_index);
+
+        while (iqs_read(&iqs, &reader, &sample) == IQS_OK)
+        {
+            float32_t tx_error = 0, rx_error = 0, phase = 0;
+
+            iqs_to_data(&sample, &data);
+            tx_error = 1e6f * fabsf(data.tx_signal_magnitude - tx_expected) / tx_expected;
+            rx_error = 1e6f * fabsf(data.rx_signal_magnitude - rx_expected) / rx_expected;
+            magnitude_error = (tx_error > magnitude_error) ? tx_error : magnitude_error;
+            magnitude_error = (rx_error > magnitude_error) ? rx_error : magnitude_error;
+            phase = 1e3f * fabsf(atan2f(data.cross_imag, data.cross_real) + (float32_t)TEST_IQS_PHASE);
+            phase_error = (phase > phase_error) ? phase : phase_error;
+            broken += (sample.sequence != reader.received - 1) || !sample.continuous;
+        }
+    }
+
+    test_check(produced == TEST_IQS_SAMPLES / IQS_DECIMATION, "iqs_rate I/Q samples", (float32_t)produced,
+               (float32_t)(TEST_IQS_SAMPLES / IQS_DECIMATION));
+    test_check(fabsf(period - requested_period) <= 0.5f * (float32_t)FP_MT_TABLE_LEN / FP_SAMPLE_RATE_HZ,
+               "iqs_rate rate Hz", IQS_RATE_HZ, (float32_t)SIG_IQ_STREAM_RATE_HZ);
+    test_check(broken == 0, "iqs_rate out of sequence", (float32_t)broken, 0.0f);
+    test_check(magnitude_error <= TEST_IQS_MAX_ERROR_PPM, "iqs_rate magnitude error ppm", magnitude_error,
+               TEST_IQS_MAX_ERROR_PPM);
+    test_check(phase_error <= TEST_IQS_MAX_PHASE_MRAD, "iqs_rate phase error mrad", phase_error,
+               TEST_IQS_MAX_PHASE_MRAD);
+}
+
+
+/**
+ * @brief Checks that the readers of the I/Q stream keep their own read positions.
+ *
+ * TEST_IQS_BLOCKS blocks are written to the stream. A fast reader reads
+ * after every block and must receive every I/Q sample in sequence. A slow
+ * reader reads only every TEST_IQS_SLOW_PERIOD blocks, so the ring is
+ * overwritten under it: it must count the overwritten I/Q samples as lost,
+ * continue in sequence after them, and must not disturb the fast reader. A
+ * reader that starts halfway receives only the I/Q samples produced after
+ * its start. Finally the backlog is let grow past IQS_MAX_BACKLOG, and the
+ * first I/Q sample after the restart must be flagged to every reader.
+ */
+static void test_iqs_readers(void)
+{
+    static SIG_Handle_t sig;
+    static IQS_Handle_t iqs;
+    IQS_Reader_t fast = {0}, slow = {0}, late = {0};
+    IQS_Sample_t sample = {0};
+    uint32_t fast_broken = 0, slow_broken = 0, slow_next = 0, late_start = 0, flagged = 0;
+    uint64_t written = 0;
+    uint16_t write_index = 0;
+
+    sig.dc_offset = (uint16_t)( 1U << (SIG_ADC_BITS - 1) );
+    iqs_init(&iqs, write_index);
+    iqs_reader_init(&iqs, &fast);
+    iqs_reader_init(&iqs, &slow);
+
+    for(uint32_t block = 1; block <= TEST_IQS_BLOCKS; block++)
+    {
+        test_iqs_write(&sig, &write_index, &written, BUFF_TO_DFT_LEN);
+        (void) iqs_update(&iqs, &sig, write_index);
+
+        while (iqs_read(&iqs, &fast, &sample) == IQS_OK)
+        {
+            fast_broken += (sample.sequence != fast.received - 1);
+        }
+
+        if ( ( (block % TEST_IQS_SLOW_PERIOD) == 0 ) || (block == TEST_IQS_BLOCKS) )
+        {
+            while (iqs_read(&iqs, &slow, &sample) == IQS_OK)
+            {
+                /* After a loss the reader continues with the oldest I/Q sample kept */
+                slow_broken += (sample.sequence != slow_next)
+                               && (sample.sequence != iqs.write_index - IQS_RING_LEN + 1);
+                slow_next = sample.sequence + 1;
+            }
+        }
+
+        if (block == TEST_IQS_BLOCKS / 2)
+        {
+            iqs_reader_init(&iqs, &late);
+            late_start = iqs.write_index;
+        }
+        if (block > TEST_IQS_BLOCKS / 2)
+        {
+            while (iqs_read(&iqs, &late, &sample) == IQS_OK)
+            {
+            }
+        }
+    }
+
+    test_check( (fast.received == iqs.write_index) && (fast.lost == 0) && (fast_broken == 0),
+                "iqs_readers fast reader I/Q samples", (float32_t)fast.received, (float32_t)iqs.write_index);
+    test_check( (slow.received + slow.lost == iqs.write_index) && (slow.lost > 0) && (slow_broken == 0),
+                "iqs_readers slow reader I/Q samples and lost", (float32_t)(slow.received + slow.lost),
+                (float32_t)iqs.write_index);
+    test_check( (late.received == iqs.write_index - late_start) && (late.lost == 0),
+                "iqs_readers late reader I/Q samples", (float32_t)late.received,
+                (float32_t)(iqs.write_index - late_start));
+
+    /* Let the DMA run ahead of the stream, then continue normally */
+    test_iqs_write(&sig, &write_index, &written, IQS_MAX_BACKLOG + 1);
+    (void) iqs_update(&iqs, &sig, write_index);
+    test_iqs_write(&sig, &write_index, &written, 2 * IQS_DECIMATION);
+    (void) iqs_update(&iqs, &sig, write_index);
+
+    if (iqs_read(&iqs, &fast, &sample) == IQS_OK)
+    {
+        flagged += !sample.continuous;
+    }
+    if (iqs_read(&iqs, &fast, &sample) == IQS_OK)
+    {
+        flagged += sample.continuous;
+    }
+    if (iqs_read(&iqs, &late, &sample) == IQS_OK)
+    {
+        flagged += !sample.continuous;
+    }
+
+    test_check( (iqs.restarts == 1) && (flagged == 3), "iqs_readers restart flagged", (float32_t)flagged, 3.0f);
+}
+
+
+/**
+ * @brief Runs every test.
+ *
+ * @return int Number of failed checks, 0 if all passed.
+ */
+int main(void)
+{
+    test_sa_snr(TEST_BLOCK_PERIOD_MS);
+    test_sa_snr(TEST_SUBBLOCK_PERIOD_MS);
+    test_sa_decay(TEST_BLOCK_PERIOD_MS);
+    test_sa_decay(TEST_SUBBLOCK_PERIOD_MS);
+    test_md_motion(TEST_BLOCK_PERIOD_MS);
+    test_md_motion(TEST_SUBBLOCK_PERIOD_MS);
+    test_tt_variance();
+    test_pfft_split();
+    test_lk_convert();
+    test_sdft_drift();
+    test_sdft_latency();
+    test_dec_process();
+    test_dec_gain();
+    test_iqs_rate();
+    test_iqs_readers();
+
+    printf("%u check(s) failed\n", (unsigned)test_failures);
+
+    return (int)test_failures;
+}
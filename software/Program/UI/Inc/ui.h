@@ -14,6 +14,7 @@
 #define _METALDETECTOR_UI_H
 
 #include "lvgl.h"
+#include "discrimination.h"
 
 /** @brief Length of the time domain chart. */
 #define TIME_DOMAIN_CHART_LEN                    100
@@ -49,6 +50,11 @@ extern lv_obj_t * ui_PhaseLabel;
 extern lv_obj_t * ui_DepthPanel;
 extern lv_obj_t * ui_DepthBar;
 extern lv_obj_t * ui_DepthLabel;
+extern lv_obj_t * ui_NotchStrip;
+extern lv_obj_t * ui_NotchPresetButton;
+extern lv_obj_t * ui_NotchPresetLabel;
+extern lv_obj_t * ui_NotchCells[DS_CLASS_COUNT];
+extern lv_obj_t * ui_NotchCellLabels[DS_CLASS_COUNT];
 extern lv_obj_t * ui_SettingsTab_;
 extern lv_obj_t * ui_GndBalancePanel;
 extern lv_obj_t * ui_GndBalanceConf;
@@ -68,6 +74,10 @@ extern lv_obj_t * ui_Chart_Yaxis1;
 extern lv_obj_t * ui_Chart_Yaxis2;
 extern lv_chart_series_t * ui_Chart_series_1;
 extern lv_chart_series_t * ui_Chart_series_2;
+extern lv_obj_t * ui_DiagTab_;
+extern lv_obj_t * ui_DiagLabel;
+extern lv_obj_t * ui_DiagResetButton;
+extern lv_obj_t * ui_DiagResetBtnLabel;
 extern lv_obj_t * ui____initial_actions0;
 
 /**
@@ -49,5 +49,29 @@ void sens_changed_cb(lv_event_t * e);
  */
 void chart_domain_changed_cb(lv_event_t * e);
 
+/**
+ * @brief Callback for when the diagnostics reset button is pressed.
+ * @param e The event object
+ */
+void diag_reset_cb(lv_event_t * e);
+
+/**
+ * @brief Callback for when a class cell of the notch strip is clicked.
+ * @param e The event object, its user data is the class of the cell
+ */
+void notch_cell_clicked_cb(lv_event_t * e);
+
+/**
+ * @brief Callback for when the preset cell of the notch strip is clicked.
+ * @param e The event object
+ */
+void notch_preset_clicked_cb(lv_event_t * e);
+
+/**
+ * @brief Redraws the notch strip from the active discrimination preset.
+ * @param target_class Class to be marked, -1 for none
+ */
+void notch_strip_refresh(int8_t target_class);
+
 
 #endif // _UI_CALLBACKS_H
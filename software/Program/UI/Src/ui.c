@@ -24,6 +24,11 @@ lv_obj_t * ui_PhaseLabel;               			/**< Phase label object */
 lv_obj_t * ui_DepthPanel;               			/**< Depth panel object */
 lv_obj_t * ui_DepthBar;                 			/**< Depth bar object */
 lv_obj_t * ui_DepthLabel;               			/**< Depth label object */
+lv_obj_t * ui_NotchStrip;               			/**< Notch strip container object */
+lv_obj_t * ui_NotchPresetButton;        			/**< Notch strip preset button object */
+lv_obj_t * ui_NotchPresetLabel;         			/**< Notch strip preset label object */
+lv_obj_t * ui_NotchCells[DS_CLASS_COUNT];			/**< Notch strip class cell objects */
+lv_obj_t * ui_NotchCellLabels[DS_CLASS_COUNT];		/**< Notch strip class label objects */
 lv_obj_t * ui_SettingsTab_;             			/**< Settings tab object */
 lv_obj_t * ui_GndBalancePanel;          			/**< Ground balance panel object */
 lv_obj_t * ui_GndBalanceConf;           			/**< Ground balance configuration slider object */
@@ -43,6 +48,10 @@ lv_obj_t * ui_Chart_Yaxis1;             			/**< Chart Y-axis 1 scale object */
 lv_obj_t * ui_Chart_Yaxis2;             			/**< Chart Y-axis 2 scale object */
 lv_chart_series_t * ui_Chart_series_1; 				/**< Chart series 1 object */
 lv_chart_series_t * ui_Chart_series_2; 				/**< Chart series 2 object */
+lv_obj_t * ui_DiagTab_;                 			/**< Diagnostics tab object */
+lv_obj_t * ui_DiagLabel;                			/**< Diagnostics text label object */
+lv_obj_t * ui_DiagResetButton;          			/**< Diagnostics reset button object */
+lv_obj_t * ui_DiagResetBtnLabel;        			/**< Diagnostics reset button label object */
 lv_obj_t * ui____initial_actions0;     			 	/**< Initial actions object */
 
 
@@ -53,6 +62,7 @@ static void tab_init(void);
 static void tab_main_init(void);
 static void tab_settings_init(void);
 static void tab_chart_init(void);
+static void tab_diag_init(void);
 static void tab_callbacks_init(void);
 
 
@@ -76,6 +86,9 @@ void ui_init(void)
     tab_init();
     tab_callbacks_init();
 
+    /* Show the active discrimination preset */
+    notch_strip_refresh(-1);
+
     /* Create an initial UI object and load the main screen */
     ui____initial_actions0 = lv_obj_create(NULL);
     lv_disp_load_scr(ui_Main);
@@ -88,7 +101,7 @@ void ui_init(void)
  * This function creates the main screen object and a tab view. It configures the
  * tab view by setting its size, alignment, and background color. It also removes
  * certain flags to control its behavior, such as scrollable and gesture bubble.
- * Additionally, it initializes each specific tab (main, settings, chart).
+ * Additionally, it initializes each specific tab (main, settings, chart, diagnostics).
  */
 static void tab_init(void)
 {
@@ -112,6 +125,7 @@ static void tab_init(void)
     tab_main_init();
     tab_settings_init();
     tab_chart_init();
+    tab_diag_init();
 }
 
 
@@ -122,6 +136,7 @@ static void tab_init(void)
  * It sets up various UI elements such as panels, arcs, labels, and bars with specific styles
  * and properties. The main components include:
  * - A phase main panel with a centered arc and decorative circle.
+ * - A notch strip below the arc with the discrimination preset and a cell per target class.
  * - A depth panel with a vertical bar and a label.
  */
 static void tab_main_init(void)
@@ -191,6 +206,55 @@ static void tab_main_init(void)
     lv_obj_set_style_text_opa(ui_PhaseLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_font(ui_PhaseLabel, &lv_font_montserrat_18, LV_PART_MAIN | LV_STATE_DEFAULT);
 
+    /* Create and configure the notch strip in the opening of the phase arc */
+    ui_NotchStrip = lv_obj_create(ui_MainTab_);
+    lv_obj_set_width(ui_NotchStrip, 198);
+    lv_obj_set_height(ui_NotchStrip, 20);
+    lv_obj_set_x(ui_NotchStrip, -44);
+    lv_obj_set_y(ui_NotchStrip, 80);
+    lv_obj_set_align(ui_NotchStrip, LV_ALIGN_CENTER);
+    lv_obj_remove_flag(ui_NotchStrip, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_pad_all(ui_NotchStrip, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_radius(ui_NotchStrip, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_NotchStrip, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_opa(ui_NotchStrip, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    /* Create and configure the preset button of the notch strip */
+    ui_NotchPresetButton = lv_button_create(ui_NotchStrip);
+    lv_obj_set_width(ui_NotchPresetButton, 44);
+    lv_obj_set_height(ui_NotchPresetButton, 20);
+    lv_obj_set_align(ui_NotchPresetButton, LV_ALIGN_LEFT_MID);
+    lv_obj_remove_flag(ui_NotchPresetButton, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_pad_all(ui_NotchPresetButton, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_NotchPresetLabel = lv_label_create(ui_NotchPresetButton);
+    lv_obj_set_width(ui_NotchPresetLabel, LV_SIZE_CONTENT);
+    lv_obj_set_height(ui_NotchPresetLabel, LV_SIZE_CONTENT);
+    lv_obj_set_align(ui_NotchPresetLabel, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_NotchPresetLabel, "");
+
+    /* Create a cell per target class, its color shows whether the class is accepted */
+    for(uint32_t c = 0; c < DS_CLASS_COUNT; c++)
+    {
+        ui_NotchCells[c] = lv_button_create(ui_NotchStrip);
+        lv_obj_set_width(ui_NotchCells[c], 28);
+        lv_obj_set_height(ui_NotchCells[c], 20);
+        lv_obj_set_x(ui_NotchCells[c], 48 + 30 * c);
+        lv_obj_set_align(ui_NotchCells[c], LV_ALIGN_LEFT_MID);
+        lv_obj_remove_flag(ui_NotchCells[c], LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_set_style_pad_all(ui_NotchCells[c], 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_radius(ui_NotchCells[c], 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_color(ui_NotchCells[c], lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_width(ui_NotchCells[c], 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        ui_NotchCellLabels[c] = lv_label_create(ui_NotchCells[c]);
+        lv_obj_set_width(ui_NotchCellLabels[c], LV_SIZE_CONTENT);
+        lv_obj_set_height(ui_NotchCellLabels[c], LV_SIZE_CONTENT);
+        lv_obj_set_align(ui_NotchCellLabels[c], LV_ALIGN_CENTER);
+        lv_label_set_text(ui_NotchCellLabels[c], ds_class_names[c]);
+        lv_obj_set_style_text_color(ui_NotchCellLabels[c], lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+
     /* Create and configure the depth panel */
     ui_DepthPanel = lv_obj_create(ui_MainTab_);
     lv_obj_set_width(ui_DepthPanel, 87);
@@ -502,6 +566,47 @@ static void tab_chart_init(void)
 }
 
 
+/**
+ * @brief Initializes the "Diag" tab in the tab view widget.
+ *
+ * This function creates and configures the "Diag" tab, which shows the timing
+ * statistics of the signal processing task in a text label, and a button
+ * that restarts the statistics.
+ */
+static void tab_diag_init(void)
+{
+    /* Add a new tab named "Diag" to the tab view widget */
+    ui_DiagTab_ = lv_tabview_add_tab(ui_Tab, "Diag");
+    lv_obj_remove_flag(ui_DiagTab_, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_SNAPPABLE | LV_OBJ_FLAG_SCROLLABLE |
+                       LV_OBJ_FLAG_SCROLL_ELASTIC | LV_OBJ_FLAG_SCROLL_MOMENTUM | LV_OBJ_FLAG_SCROLL_CHAIN);
+    lv_obj_set_scrollbar_mode(ui_DiagTab_, LV_SCROLLBAR_MODE_OFF);
+
+    /* Create and configure the label holding the statistics */
+    ui_DiagLabel = lv_label_create(ui_DiagTab_);
+    lv_obj_set_width(ui_DiagLabel, 300);
+    lv_obj_set_height(ui_DiagLabel, LV_SIZE_CONTENT);
+    lv_obj_set_align(ui_DiagLabel, LV_ALIGN_TOP_LEFT);
+    lv_label_set_text(ui_DiagLabel, "No frames recorded");
+    lv_obj_set_style_text_color(ui_DiagLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_DiagLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    /* Create and configure a button for restarting the statistics */
+    ui_DiagResetButton = lv_button_create(ui_DiagTab_);
+    lv_obj_set_width(ui_DiagResetButton, 62);
+    lv_obj_set_height(ui_DiagResetButton, 23);
+    lv_obj_set_align(ui_DiagResetButton, LV_ALIGN_BOTTOM_RIGHT);
+    lv_obj_add_flag(ui_DiagResetButton, LV_OBJ_FLAG_SCROLL_ON_FOCUS);
+    lv_obj_remove_flag(ui_DiagResetButton, LV_OBJ_FLAG_SCROLLABLE);
+
+    /* Create and configure a label for the reset button */
+    ui_DiagResetBtnLabel = lv_label_create(ui_DiagResetButton);
+    lv_obj_set_width(ui_DiagResetBtnLabel, LV_SIZE_CONTENT);
+    lv_obj_set_height(ui_DiagResetBtnLabel, LV_SIZE_CONTENT);
+    lv_obj_set_align(ui_DiagResetBtnLabel, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_DiagResetBtnLabel, "Reset");
+}
+
+
 /**
  * @brief Initializes event callbacks for UI components in the tab view.
  *
@@ -527,5 +632,17 @@ static void tab_callbacks_init(void)
 
     /* Add event callback for changes in the chart domain dropdown */
     lv_obj_add_event_cb(ui_ChartDomainDropdown, chart_domain_changed_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+    /* Add event callback for clicking the diagnostics reset button */
+    lv_obj_add_event_cb(ui_DiagResetButton, diag_reset_cb, LV_EVENT_CLICKED, NULL);
+
+    /* Add event callback for clicking the preset of the notch strip */
+    lv_obj_add_event_cb(ui_NotchPresetButton, notch_preset_clicked_cb, LV_EVENT_CLICKED, NULL);
+
+    /* Add event callbacks for clicking the class cells of the notch strip, the class is passed as user data */
+    for(uint32_t c = 0; c < DS_CLASS_COUNT; c++)
+    {
+        lv_obj_add_event_cb(ui_NotchCells[c], notch_cell_clicked_cb, LV_EVENT_CLICKED, (void *)(uintptr_t)c);
+    }
 }
 
@@ -9,7 +9,11 @@
  */
 
 #include "ui.h"
+#include "ui_callbacks.h"
 #include "metal_detecting.h"
+#include "ground_balance.h"
+#include "discrimination.h"
+#include "deadline_monitor.h"
 
 
 /**
@@ -76,11 +80,15 @@ void sens_changed_cb(lv_event_t * e)
 
 /**
  * @brief Callback for when the ground balance button is pressed.
+ *
+ * Only requests the ground capture, the signal processing task runs it while
+ * the coil is pumped over the ground and the GUI task shows its progress.
+ *
  * @param e The event object
  */
 void gnd_balance_set_cb(lv_event_t * e)
 {
-    /* TODO */
+    gb_start(&gb_handle);
 }
 
 /**
@@ -110,5 +118,67 @@ void chart_domain_changed_cb(lv_event_t * e)
     }
 }
 
+/**
+ * @brief Callback for when the diagnostics reset button is pressed.
+ * @param e The event object
+ */
+void diag_reset_cb(lv_event_t * e)
+{
+    dm_reset(&dm_handle);
+}
+
+/**
+ * @brief Class marked on the notch strip, -1 for none.
+ */
+static int8_t notch_marked_class = -1;
+
+/**
+ * @brief Callback for when a class cell of the notch strip is clicked.
+ *
+ * Toggles the class in the custom preset, which starts from the active one.
+ *
+ * @param e The event object, its user data is the class of the cell
+ */
+void notch_cell_clicked_cb(lv_event_t * e)
+{
+    DS_Class_t target_class = (DS_Class_t)(uintptr_t)lv_event_get_user_data(e);
+
+    ds_set_notch(&ds_handle, target_class, !ds_accept(&ds_handle, target_class));
+    notch_strip_refresh(notch_marked_class);
+}
+
+/**
+ * @brief Callback for when the preset cell of the notch strip is clicked.
+ *
+ * Selects the next preset, the phase table is not touched.
+ *
+ * @param e The event object
+ */
+void notch_preset_clicked_cb(lv_event_t * e)
+{
+    ds_set_preset(&ds_handle, (DS_Preset_t)( (ds_handle.preset + 1) % DS_PRESET_COUNT ));
+    notch_strip_refresh(notch_marked_class);
+}
+
+/**
+ * @brief Redraws the notch strip from the active discrimination preset.
+ *
+ * Accepted classes are shown green and notched out ones red, the marked
+ * class gets a white border.
+ *
+ * @param target_class Class to be marked, -1 for none
+ */
+void notch_strip_refresh(int8_t target_class)
+{
+    notch_marked_class = target_class;
 
+    lv_label_set_text(ui_NotchPresetLabel, ds_preset_names[ds_handle.preset]);
 
+    for(uint32_t c = 0; c < DS_CLASS_COUNT; c++)
+    {
+        lv_color_t color = ds_accept(&ds_handle, (DS_Class_t)c) ? lv_color_hex(0x2E9E4F) : lv_color_hex(0xC0392B);
+
+        lv_obj_set_style_bg_color(ui_NotchCells[c], color, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_width(ui_NotchCells[c], ( (int8_t)c == target_class ) ? 2 : 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+}